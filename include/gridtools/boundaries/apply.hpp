@@ -9,6 +9,11 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "../common/array.hpp"
 #include "../common/defs.hpp"
 #include "../common/halo_descriptor.hpp"
@@ -26,6 +31,127 @@ namespace gridtools {
          * @{
          */
 
+        namespace apply_impl_ {
+            template <std::size_t D>
+            using direction_at = direction<sign(int(D / 9) - 1), sign(int(D / 3 % 3) - 1), sign(int(D % 3) - 1)>;
+
+            // calls f(direction_at<d>()) for the runtime direction index d
+            template <class F, std::size_t... Ds>
+            void dispatch(int d, F &&f, std::index_sequence<Ds...>) {
+                (void)((d == int(Ds) && (f(direction_at<Ds>()), true)) || ...);
+            }
+
+            template <class F>
+            void dispatch(int d, F &&f) {
+                dispatch(d, f, std::make_index_sequence<27>());
+            }
+
+            // whether the boundary function requires the directions to be applied one after the other
+            template <class BoundaryFunction, class = void>
+            struct has_ordered_directions : std::false_type {};
+
+            template <class BoundaryFunction>
+            struct has_ordered_directions<BoundaryFunction, std::enable_if_t<BoundaryFunction::ordered_directions>>
+                : std::true_type {};
+
+            /** @brief A non empty halo region selected by the predicate. Its rows are the (j, k) lines. */
+            struct work_item {
+                int direction;
+                int_t i_low, i_high;
+                int_t j_low, j_size;
+                int_t k_low, k_size;
+            };
+
+            /** @brief The boundary function bound to the views, with the list of the active halo regions. */
+            template <class BoundaryFunction, class... Views>
+            struct task {
+                BoundaryFunction m_boundary_function;
+                std::tuple<Views...> m_views;
+                work_item m_items[26];
+                int m_num_items = 0;
+
+                task(BoundaryFunction const &bf, Views const &...views) : m_boundary_function(bf), m_views(views...) {}
+
+                void add(work_item const &item) {
+                    if (item.i_high < item.i_low || item.j_size <= 0 || item.k_size <= 0)
+                        return;
+                    m_items[m_num_items++] = item;
+                }
+
+                template <class Direction>
+                void apply_row(Direction dir, work_item const &item, std::size_t row) const {
+                    int_t j = item.j_low + int_t(row / item.k_size);
+                    int_t k = item.k_low + int_t(row % item.k_size);
+                    std::apply(
+                        [&](auto const &...views) {
+#pragma omp simd
+                            for (int_t i = item.i_low; i <= item.i_high; ++i)
+                                m_boundary_function(dir, views..., i, j, k);
+                        },
+                        m_views);
+                }
+
+                /** @brief Shares the rows of each halo region among the threads of the enclosing parallel region,
+                   without waiting for the other threads between the regions, unless the boundary function requires
+                   ordered directions. Must be called by all the threads. */
+                void apply_rows() const {
+                    for (int n = 0; n != m_num_items; ++n) {
+                        auto const &item = m_items[n];
+                        dispatch(item.direction, [&](auto dir) {
+                            std::size_t num_rows = std::size_t(item.j_size) * item.k_size;
+                            if constexpr (has_ordered_directions<BoundaryFunction>::value) {
+#pragma omp for schedule(static)
+                                for (std::size_t row = 0; row < num_rows; ++row)
+                                    apply_row(dir, item, row);
+                            } else {
+#pragma omp for schedule(static) nowait
+                                for (std::size_t row = 0; row < num_rows; ++row)
+                                    apply_row(dir, item, row);
+                            }
+                        });
+                    }
+                }
+
+                /** @brief Applies all the halo regions in the calling thread. */
+                void apply_serial() const {
+                    for (int n = 0; n != m_num_items; ++n) {
+                        auto const &item = m_items[n];
+                        dispatch(item.direction, [&](auto dir) {
+                            std::size_t num_rows = std::size_t(item.j_size) * item.k_size;
+                            for (std::size_t row = 0; row < num_rows; ++row)
+                                apply_row(dir, item, row);
+                        });
+                    }
+                }
+            };
+
+            /** @brief Applies the tasks in order in a single parallel region. The halo regions of a task are
+               processed concurrently, hence the small regions (edges and corners) do not cost a fork/join each. The
+               threads wait for each other only between the tasks, such that a task sees the values written by the
+               previous ones. */
+            template <class... Tasks>
+            void run(Tasks const &...tasks) {
+#pragma omp parallel
+                {
+                    auto apply = [](auto const &task) {
+                        task.apply_rows();
+#pragma omp barrier
+                    };
+                    (apply(tasks), ...);
+                }
+            }
+        } // namespace apply_impl_
+
+        /**
+           @brief Applies a boundary function to the halo regions of the 26 directions accepted by the predicate.
+
+           The halo regions of the different directions are applied concurrently by the threads, hence a boundary
+           function must not read the halo points written in another direction, e.g. a corner extrapolated from the
+           adjacent face halos. A boundary function which needs to declares `static constexpr bool
+           ordered_directions = true;`, then the directions are applied one after the other, in the order of their
+           indices (i + 1) * 9 + (j + 1) * 3 + k + 1, each of them still shared among the threads. The GPU
+           implementation (boundary_apply_gpu) always applies the directions concurrently.
+        */
         template <typename BoundaryFunction,
             typename Predicate = default_predicate,
             typename HaloDescriptors = array<halo_descriptor, 3u>>
@@ -35,26 +161,6 @@ namespace gridtools {
             BoundaryFunction const boundary_function;
             Predicate predicate;
 
-            /** @brief loops on the halo region defined by the HaloDescriptor member parameter, and evaluates the
-               boundary_function in the specified direction, in the specified halo node.
-                this macro expands to n definitions of the function loop, taking a number of arguments ranging from 0 to
-               n (DataField0, Datafield1, DataField2, ...)*/
-            template <typename Direction, typename... DataField>
-            void loop(DataField &...data_field) const {
-                const int_t i_low = halo_descriptors[0].loop_low_bound_outside(Direction::i);
-                const int_t i_high = halo_descriptors[0].loop_high_bound_outside(Direction::i);
-                const int_t j_low = halo_descriptors[1].loop_low_bound_outside(Direction::j);
-                const int_t j_high = halo_descriptors[1].loop_high_bound_outside(Direction::j);
-                const int_t k_low = halo_descriptors[2].loop_low_bound_outside(Direction::k);
-                const int_t k_high = halo_descriptors[2].loop_high_bound_outside(Direction::k);
-
-#pragma omp parallel for simd collapse(3)
-                for (int_t j = j_low; j <= j_high; ++j)
-                    for (int_t k = k_low; k <= k_high; ++k)
-                        for (int_t i = i_low; i <= i_high; ++i)
-                            boundary_function(Direction(), data_field..., i, j, k);
-            }
-
           public:
             boundary_apply(HaloDescriptors const &hd, Predicate predicate = Predicate())
                 : halo_descriptors(hd), boundary_function(BoundaryFunction()), predicate(predicate) {}
@@ -62,6 +168,36 @@ namespace gridtools {
             boundary_apply(HaloDescriptors const &hd, BoundaryFunction const &bf, Predicate predicate = Predicate())
                 : halo_descriptors(hd), boundary_function(bf), predicate(predicate) {}
 
+            /**
+               @brief binds the boundary function to the views and collects the halo regions, in all the directions
+               accepted by the predicate. The returned task can be applied together with others by apply_impl_::run.
+            */
+            template <typename... DataFieldViews>
+            apply_impl_::task<BoundaryFunction, DataFieldViews...> make_task(
+                DataFieldViews const &...data_field_views) const {
+                apply_impl_::task<BoundaryFunction, DataFieldViews...> res(boundary_function, data_field_views...);
+                for (int d = 0; d != 27; ++d) {
+                    if (d == 13)
+                        continue;
+                    apply_impl_::dispatch(d, [&](auto dir) {
+                        using dir_t = decltype(dir);
+                        if (!predicate(dir))
+                            return;
+                        auto const &hi = halo_descriptors[0];
+                        auto const &hj = halo_descriptors[1];
+                        auto const &hk = halo_descriptors[2];
+                        res.add({d,
+                            hi.loop_low_bound_outside(dir_t::i),
+                            hi.loop_high_bound_outside(dir_t::i),
+                            hj.loop_low_bound_outside(dir_t::j),
+                            hj.loop_high_bound_outside(dir_t::j) - hj.loop_low_bound_outside(dir_t::j) + 1,
+                            hk.loop_low_bound_outside(dir_t::k),
+                            hk.loop_high_bound_outside(dir_t::k) - hk.loop_low_bound_outside(dir_t::k) + 1});
+                    });
+                }
+                return res;
+            }
+
             /**
                @brief applies the boundary conditions looping on the halo region defined by the member parameter, in all
             possible directions.
@@ -71,69 +207,7 @@ namespace gridtools {
             */
             template <typename... DataFieldViews>
             void apply(DataFieldViews const &...data_field_views) const {
-
-                if (predicate(direction<minus_, minus_, minus_>()))
-                    this->loop<direction<minus_, minus_, minus_>>(data_field_views...);
-                if (predicate(direction<minus_, minus_, zero_>()))
-                    this->loop<direction<minus_, minus_, zero_>>(data_field_views...);
-                if (predicate(direction<minus_, minus_, plus_>()))
-                    this->loop<direction<minus_, minus_, plus_>>(data_field_views...);
-
-                if (predicate(direction<minus_, zero_, minus_>()))
-                    this->loop<direction<minus_, zero_, minus_>>(data_field_views...);
-                if (predicate(direction<minus_, zero_, zero_>()))
-                    this->loop<direction<minus_, zero_, zero_>>(data_field_views...);
-                if (predicate(direction<minus_, zero_, plus_>()))
-                    this->loop<direction<minus_, zero_, plus_>>(data_field_views...);
-
-                if (predicate(direction<minus_, plus_, minus_>()))
-                    this->loop<direction<minus_, plus_, minus_>>(data_field_views...);
-                if (predicate(direction<minus_, plus_, zero_>()))
-                    this->loop<direction<minus_, plus_, zero_>>(data_field_views...);
-                if (predicate(direction<minus_, plus_, plus_>()))
-                    this->loop<direction<minus_, plus_, plus_>>(data_field_views...);
-
-                if (predicate(direction<zero_, minus_, minus_>()))
-                    this->loop<direction<zero_, minus_, minus_>>(data_field_views...);
-                if (predicate(direction<zero_, minus_, zero_>()))
-                    this->loop<direction<zero_, minus_, zero_>>(data_field_views...);
-                if (predicate(direction<zero_, minus_, plus_>()))
-                    this->loop<direction<zero_, minus_, plus_>>(data_field_views...);
-
-                if (predicate(direction<zero_, zero_, minus_>()))
-                    this->loop<direction<zero_, zero_, minus_>>(data_field_views...);
-                if (predicate(direction<zero_, zero_, plus_>()))
-                    this->loop<direction<zero_, zero_, plus_>>(data_field_views...);
-
-                if (predicate(direction<zero_, plus_, minus_>()))
-                    this->loop<direction<zero_, plus_, minus_>>(data_field_views...);
-                if (predicate(direction<zero_, plus_, zero_>()))
-                    this->loop<direction<zero_, plus_, zero_>>(data_field_views...);
-                if (predicate(direction<zero_, plus_, plus_>()))
-                    this->loop<direction<zero_, plus_, plus_>>(data_field_views...);
-
-                if (predicate(direction<plus_, minus_, minus_>()))
-                    this->loop<direction<plus_, minus_, minus_>>(data_field_views...);
-                if (predicate(direction<plus_, minus_, zero_>()))
-                    this->loop<direction<plus_, minus_, zero_>>(data_field_views...);
-                if (predicate(direction<plus_, minus_, plus_>()))
-                    this->loop<direction<plus_, minus_, plus_>>(data_field_views...);
-
-                if (predicate(direction<plus_, zero_, minus_>()))
-                    this->loop<direction<plus_, zero_, minus_>>(data_field_views...);
-                if (predicate(direction<plus_, zero_, zero_>()))
-                    this->loop<direction<plus_, zero_, zero_>>(data_field_views...);
-                if (predicate(direction<plus_, zero_, plus_>()))
-                    this->loop<direction<plus_, zero_, plus_>>(data_field_views...);
-
-                if (predicate(direction<plus_, plus_, minus_>()))
-                    this->loop<direction<plus_, plus_, minus_>>(data_field_views...);
-                if (predicate(direction<plus_, plus_, zero_>()))
-                    this->loop<direction<plus_, plus_, zero_>>(data_field_views...);
-                if (predicate(direction<plus_, plus_, plus_>()))
-                    this->loop<direction<plus_, plus_, plus_>>(data_field_views...);
-
-                // apply(data_field_views ...);
+                apply_impl_::run(make_task(data_field_views...));
             }
 
           private:
@@ -69,6 +69,15 @@ namespace gridtools {
             void apply(DataFields &...data_fields) const {
                 bc_apply.apply(data_fields->target_view()...);
             }
+
+            /**
+               @brief Binds the boundary condition to the target views of the data fields, such that several boundary
+               conditions can be applied in a single parallel region (see boundary_apply::make_task). Host only.
+            */
+            template <typename... DataFields>
+            auto make_task(DataFields &...data_fields) const {
+                return bc_apply.make_task(data_fields->target_view()...);
+            }
         };
 
         template <class Arch, class BoundaryFunction, class Predicate = default_predicate>
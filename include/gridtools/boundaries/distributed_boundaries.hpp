@@ -13,9 +13,18 @@
 /** \defgroup Distributed-Boundaries Distributed Boundary Conditions
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <tuple>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "../common/halo_descriptor.hpp"
 #include "../common/timer/timer.hpp"
@@ -29,6 +38,62 @@ namespace gridtools {
         /** \ingroup Distributed-Boundaries
          * @{ */
 
+        /**
+            @brief The compute domain split into the part that does not depend on the halos (at most one box) and the
+            boundary strips that do. Each box is an array of 3 gridtools::halo_descriptor whose begin/end delimit it.
+        */
+        struct compute_regions {
+            std::vector<array<halo_descriptor, 3>> interior;
+            std::vector<array<halo_descriptor, 3>> boundary;
+        };
+
+        /**
+            @brief Splits the compute domain described by `halos` for a computation that reads the exchanged fields
+            with the given extent (for instance, the result of gridtools::stencil::get_arg_extent). The boundary strips
+            are as wide as the extent on each side; they are disjoint and, together with the interior, cover the domain.
+        */
+        template <typename Extent>
+        compute_regions split_compute_domain(array<halo_descriptor, 3> const &halos, Extent) {
+            int_t minus[3] = {-Extent::iminus::value, -Extent::jminus::value, -Extent::kminus::value};
+            int_t plus[3] = {Extent::iplus::value, Extent::jplus::value, Extent::kplus::value};
+            int_t begin[3], end[3];
+            for (int d = 0; d < 3; ++d) {
+                int_t length = halos[d].end() + 1 - halos[d].begin();
+                minus[d] = std::min(std::max(minus[d], int_t(0)), length);
+                plus[d] = std::min(std::max(plus[d], int_t(0)), length - minus[d]);
+                begin[d] = halos[d].begin() + minus[d];
+                end[d] = halos[d].end() + 1 - plus[d];
+            }
+            auto make_box = [&](int_t const(&b)[3], int_t const(&e)[3]) {
+                array<halo_descriptor, 3> res;
+                for (int d = 0; d < 3; ++d)
+                    res[d] = halo_descriptor(
+                        halos[d].minus(), halos[d].plus(), b[d], e[d] - 1, halos[d].total_length());
+                return res;
+            };
+            compute_regions res;
+            // the strips along the dimension d cover the full range in the following dimensions
+            for (int d = 0; d < 3; ++d) {
+                int_t b[3], e[3];
+                for (int dd = 0; dd < 3; ++dd) {
+                    b[dd] = dd < d ? begin[dd] : (int_t)halos[dd].begin();
+                    e[dd] = dd < d ? end[dd] : (int_t)halos[dd].end() + 1;
+                }
+                if (minus[d] > 0) {
+                    e[d] = begin[d];
+                    res.boundary.push_back(make_box(b, e));
+                }
+                if (plus[d] > 0) {
+                    b[d] = end[d];
+                    e[d] = halos[d].end() + 1;
+                    res.boundary.push_back(make_box(b, e));
+                }
+            }
+            if (begin[0] < end[0] && begin[1] < end[1] && begin[2] < end[2])
+                res.interior.push_back(make_box(begin, end));
+            return res;
+        }
+
         /**
             @brief This class takes a communication traits class and provide a facility to
             perform boundary conditions and communications in a single call.
@@ -84,6 +149,25 @@ namespace gridtools {
             performance_meter_t m_meter_exchange;
             performance_meter_t m_meter_bc;
 
+            // the totals of the messages of the pattern
+            struct traffic {
+                std::size_t sent_bytes = 0;
+                std::size_t received_bytes = 0;
+                double wait_time = 0;
+            };
+
+            // the measurements of an exchange, see distributed_boundaries::metrics_json
+            struct exchange_sample {
+                std::size_t fields = 0;
+                traffic messages;
+                double pack_time = 0;
+                double unpack_time = 0;
+            };
+
+            std::vector<exchange_sample> m_samples;
+            exchange_sample m_sample;  // the exchange in progress
+            traffic m_traffic_before; // the totals at the beginning of the exchange in progress
+
           public:
             /**
                 @brief Constructor of distributed_boundaries.
@@ -140,9 +224,15 @@ namespace gridtools {
             */
             template <typename... Jobs>
             void boundary_only(Jobs const &...jobs) {
-                using execute_in_order = int[];
                 m_meter_bc.start();
-                (void)execute_in_order{(apply_boundary(jobs), 0)...};
+                if constexpr (std::is_same_v<typename CTraits::comm_arch_type, gcl::cpu>) {
+                    // the boundary conditions are applied in order in a single parallel region
+                    std::apply([](auto const &...tasks) { apply_impl_::run(tasks...); },
+                        std::tuple_cat(make_tasks(jobs)...));
+                } else {
+                    using execute_in_order = int[];
+                    (void)execute_in_order{(apply_boundary(jobs), 0)...};
+                }
                 m_meter_bc.pause();
             }
 
@@ -160,46 +250,317 @@ namespace gridtools {
             template <typename... Jobs>
             void exchange(Jobs const &...jobs) {
                 auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
-                if (m_max_stores < sizeof...(jobs)) {
-                    std::string err{"Too many data stores to be exchanged" + std::to_string(sizeof...(jobs)) +
-                                    " instead of the maximum allowed, which is " + std::to_string(m_max_stores)};
-                    throw std::runtime_error(err);
-                }
+                check_num_stores(sizeof...(jobs));
 
-                m_meter_pack.start();
-                call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-                m_meter_pack.pause();
+                pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
                 m_meter_exchange.start();
                 m_he->exchange();
                 m_meter_exchange.pause();
-                m_meter_pack.start();
-                call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-                m_meter_pack.pause();
+                unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+
+                boundary_only(jobs...);
+            }
+
+            /**
+                @brief First phase of a split-phase exchange: packs the data stores and initiates the communication.
+
+                The same jobs have to be passed to distributed_boundaries::wait, which completes the exchange. In
+                between, the data stores can be read (but not written) outside of their halos.
+
+                \param jobs Variadic list of jobs
+            */
+            template <typename... Jobs>
+            void start_exchange(Jobs const &...jobs) {
+                auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
+                check_num_stores(sizeof...(jobs));
+
+                pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                m_meter_exchange.start();
+                m_he->start_exchange();
+                m_meter_exchange.pause();
+            }
+
+            /**
+                @brief Second phase of a split-phase exchange: waits for the communication initiated by
+                distributed_boundaries::start_exchange, unpacks the data stores and applies the boundary conditions.
+
+                \param jobs Variadic list of jobs, the same passed to distributed_boundaries::start_exchange
+            */
+            template <typename... Jobs>
+            void wait(Jobs const &...jobs) {
+                auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
+
+                m_meter_exchange.start();
+                m_he->wait();
+                m_meter_exchange.pause();
+                unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
 
                 boundary_only(jobs...);
             }
 
+            /**
+                @brief Performs the exchange of the jobs while running a computation that reads the exchanged data
+                stores with the given extent.
+
+                `compute` is called with an array of 3 gridtools::halo_descriptor delimiting the region to compute.
+                It is first called on the interior of the domain, that does not depend on the halos, while the messages
+                are in flight. After the exchange and the boundary conditions are completed, it is called on each of
+                the boundary strips (see gridtools::boundaries::split_compute_domain). A typical `compute` runs the
+                stencil on `make_grid(region[0], region[1], axis)`.
+
+                \param extent The extent of the computation with respect to the exchanged data stores
+                \param compute The computation
+                \param jobs Variadic list of jobs
+            */
+            template <typename Extent, typename Compute, typename... Jobs>
+            void exchange_and_compute(Extent extent, Compute &&compute, Jobs const &...jobs) {
+                auto regions = split_compute_domain(m_halos, extent);
+                start_exchange(jobs...);
+                for (auto const &region : regions.interior)
+                    compute(region);
+                wait(jobs...);
+                for (auto const &region : regions.boundary)
+                    compute(region);
+            }
+
+            /**
+                @brief Returns the region to compute at a step of a cycle of computations between two exchanges of
+                deep halos.
+
+                If the halos are at least `steps` times as wide as the extent of a computation, the computation can
+                be applied `steps` times after each exchange, by computing redundantly in the halos shared with the
+                neighbors. The region of the step which has `remaining_steps` steps left in the cycle (itself included)
+                is the compute domain extended by `remaining_steps - 1` times the extent towards the neighbors. It is
+                not extended on the sides without neighbor, where the halos are set by the boundary conditions. Throws
+                std::runtime_error if, on a side with a neighbor, the halo is narrower than `remaining_steps` times the
+                extent, which the step reads.
+
+                \param extent The extent of the computation (for instance, the result of stencil::get_arg_extent)
+                \param remaining_steps The number of steps left before the next exchange, including this one
+            */
+            template <typename Extent>
+            array<halo_descriptor, 3> deep_halo_region(Extent, int_t remaining_steps) const {
+                int_t widths[3][2] = {{-Extent::iminus::value, Extent::iplus::value},
+                    {-Extent::jminus::value, Extent::jplus::value},
+                    {-Extent::kminus::value, Extent::kplus::value}};
+                array<halo_descriptor, 3> res;
+                for (int d = 0; d < 3; ++d) {
+                    // the region is extended by `ext` and the computation reads `width` further into the halos
+                    int_t ext[2], depth[2];
+                    for (int side = 0; side < 2; ++side) {
+                        int offsets[3] = {};
+                        offsets[d] = side ? 1 : -1;
+                        bool has_neighbor = proc_grid().proc(offsets[0], offsets[1], offsets[2]) != -1;
+                        int_t width = has_neighbor ? std::max(widths[d][side], int_t(0)) : 0;
+                        ext[side] = (remaining_steps - 1) * width;
+                        depth[side] = remaining_steps * width;
+                    }
+                    auto const &halo = m_halos[d];
+                    if (depth[0] > (int_t)halo.minus() || depth[1] > (int_t)halo.plus())
+                        throw std::runtime_error("The halos are too narrow for " + std::to_string(remaining_steps) +
+                                                 " steps of a computation without exchange");
+                    res[d] = halo_descriptor(halo.minus() - ext[0],
+                        halo.plus() - ext[1],
+                        halo.begin() - ext[0],
+                        halo.end() + ext[1],
+                        halo.total_length());
+                }
+                return res;
+            }
+
+            /**
+                @brief Exchanges the deep halos of the jobs once, then runs `steps` steps of a computation without
+                further exchanges.
+
+                `compute` is called `steps` times with the regions given by
+                distributed_boundaries::deep_halo_region, which shrink from step to step to the compute domain. The
+                boundary conditions of the jobs are applied after the exchange and again before each following step.
+                This trades redundant computations in the halos for fewer and larger messages.
+
+                \param steps The number of steps between two exchanges
+                \param extent The extent of the computation with respect to the exchanged data stores
+                \param compute The computation, called with an array of 3 gridtools::halo_descriptor
+                \param jobs Variadic list of jobs
+            */
+            template <typename Extent, typename Compute, typename... Jobs>
+            void exchange_and_compute_steps(int_t steps, Extent extent, Compute &&compute, Jobs const &...jobs) {
+                // throws before any communication if the halos are too narrow
+                deep_halo_region(extent, steps);
+                exchange(jobs...);
+                for (int_t step = 0; step < steps; ++step) {
+                    if (step)
+                        boundary_only(jobs...);
+                    compute(deep_halo_region(extent, steps - step));
+                }
+            }
+
             auto const &proc_grid() const { return m_he->comm(); }
 
             std::string print_meters() const {
                 return m_meter_pack.to_string() + "\n" + m_meter_exchange.to_string() + "\n" + m_meter_bc.to_string();
             }
 
-            double get_time_pack() const { return m_meter_pack.get_time(); }
-            double get_time_exchange() const { return m_meter_exchange.get_time(); }
-            double get_time_boundary() const { return m_meter_bc.get_time(); }
+            double get_time_pack() const { return m_meter_pack.total_time(); }
+            double get_time_exchange() const { return m_meter_exchange.total_time(); }
+            double get_time_boundary() const { return m_meter_bc.total_time(); }
 
-            size_t get_count_exchange() const { return m_meter_exchange.get_count(); }
+            size_t get_count_exchange() const { return m_meter_exchange.count(); }
             // no get_count_pack() as it is equivalent to get_count_exchange()
-            size_t get_count_boundary() const { return m_meter_bc.get_count(); }
+            size_t get_count_boundary() const { return m_meter_bc.count(); }
+
+            /**
+                @brief Returns the communication metrics of this process as JSON, with the schema of the output of the
+                regression perftests: an object with an array of `outputs`, each with a `name`, a `backend`, a
+                `float_type` and a `series` of values. The outputs carry the `rank` of the process and the `unit` of
+                their values as well.
+
+                The outputs `pack`, `unpack`, `wait` (the time spent waiting for the messages, which includes the
+                load imbalance with the neighbors), `pack_throughput`, `unpack_throughput` and `field_bytes` have a
+                value per exchange since the construction or the last call to reset_meters. The fields of an exchange
+                are packed together, hence the throughputs are those of all of its fields. The outputs
+                `neighbor_sent_bytes`, `neighbor_received_bytes` and `neighbor_wait` have a single value, the total of
+                the messages exchanged with the `neighbor` of relative coordinates [i, j, k] in the process grid,
+                whose rank is `peer`. The load imbalance among the processes is given by their `wait` outputs.
+            */
+            std::string metrics_json() const {
+                std::vector<double> pack, unpack, wait, pack_throughput, unpack_throughput;
+                std::vector<std::size_t> field_bytes;
+                for (auto const &sample : m_samples) {
+                    pack.push_back(sample.pack_time);
+                    unpack.push_back(sample.unpack_time);
+                    wait.push_back(sample.messages.wait_time);
+                    pack_throughput.push_back(sample.messages.sent_bytes / sample.pack_time);
+                    unpack_throughput.push_back(sample.messages.received_bytes / sample.unpack_time);
+                    field_bytes.push_back(sample.fields ? sample.messages.sent_bytes / sample.fields : 0);
+                }
+                std::ostringstream strm;
+                strm << "{\n";
+                strm << "  \"outputs\" : [";
+                int outputs = 0;
+                auto output = [&](std::string const &name, std::string const &unit, auto const &series, auto &&extra) {
+                    if (outputs++)
+                        strm << ",";
+                    strm << "\n    {\n";
+                    strm << "      \"name\" : \"" << name << "\",\n";
+                    strm << "      \"backend\" : \"" << backend_name() << "\",\n";
+                    strm << "      \"float_type\" : \"" << float_type_name() << "\",\n";
+                    strm << "      \"rank\" : " << proc_grid().pid() << ",\n";
+                    extra();
+                    strm << "      \"unit\" : \"" << unit << "\",\n";
+                    strm << "      \"series\" : [";
+                    int values = 0;
+                    for (auto val : series) {
+                        if (values++)
+                            strm << ", ";
+                        // JSON has no representation of the infinite throughputs of the timers which do not measure
+                        if (std::isfinite(double(val)))
+                            strm << val;
+                        else
+                            strm << "null";
+                    }
+                    strm << "]\n";
+                    strm << "    }";
+                };
+                auto no_extra = [] {};
+                output("pack", "s", pack, no_extra);
+                output("unpack", "s", unpack, no_extra);
+                output("wait", "s", wait, no_extra);
+                output("pack_throughput", "B/s", pack_throughput, no_extra);
+                output("unpack_throughput", "B/s", unpack_throughput, no_extra);
+                output("field_bytes", "B", field_bytes, no_extra);
+                auto const &pattern = m_he->pattern();
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            int peer = pattern.proc_grid().proc(i, j, k);
+                            if ((i == 0 && j == 0 && k == 0) || peer == -1)
+                                continue;
+                            auto const &stats = pattern.statistics(i, j, k);
+                            auto neighbor = [&] {
+                                strm << "      \"neighbor\" : [" << i << ", " << j << ", " << k << "],\n";
+                                strm << "      \"peer\" : " << peer << ",\n";
+                            };
+                            output("neighbor_sent_bytes", "B", std::vector<std::size_t>{stats.sent_bytes}, neighbor);
+                            output("neighbor_received_bytes",
+                                "B",
+                                std::vector<std::size_t>{stats.received_bytes},
+                                neighbor);
+                            output("neighbor_wait", "s", std::vector<double>{stats.wait_time}, neighbor);
+                        }
+                if (outputs)
+                    strm << "\n  ";
+                strm << "]\n";
+                strm << "}\n";
+                return strm.str();
+            }
 
             void reset_meters() {
-                m_meter_pack.reset_meter();
-                m_meter_exchange.reset_meter();
-                m_meter_bc.reset_meter();
+                m_meter_pack.reset();
+                m_meter_exchange.reset();
+                m_meter_bc.reset();
+                m_he->reset_statistics();
+                m_samples.clear();
             }
 
           private:
+            static std::string backend_name() {
+                return std::is_same_v<typename CTraits::comm_arch_type, gcl::cpu> ? "gcl_cpu" : "gcl_gpu";
+            }
+
+            static std::string float_type_name() {
+                using value_t = typename CTraits::value_type;
+                return std::is_same_v<value_t, float>    ? "float"
+                       : std::is_same_v<value_t, double> ? "double"
+                                                         : typeid(value_t).name();
+            }
+
+            traffic total_traffic() const {
+                auto const &pattern = m_he->pattern();
+                traffic res;
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            auto const &stats = pattern.statistics(i, j, k);
+                            res.sent_bytes += stats.sent_bytes;
+                            res.received_bytes += stats.received_bytes;
+                        }
+                res.wait_time = pattern.wait_time();
+                return res;
+            }
+
+            template <typename Stores, uint_t... Ids>
+            void pack(Stores const &stores, std::integer_sequence<uint_t, Ids...> ids) {
+                m_sample = {};
+                m_sample.fields = sizeof...(Ids);
+                m_traffic_before = total_traffic();
+                double time = m_meter_pack.total_time();
+                m_meter_pack.start();
+                call_pack(stores, ids);
+                m_meter_pack.pause();
+                m_sample.pack_time = m_meter_pack.total_time() - time;
+            }
+
+            template <typename Stores, uint_t... Ids>
+            void unpack(Stores const &stores, std::integer_sequence<uint_t, Ids...> ids) {
+                double time = m_meter_pack.total_time();
+                m_meter_pack.start();
+                call_unpack(stores, ids);
+                m_meter_pack.pause();
+                m_sample.unpack_time = m_meter_pack.total_time() - time;
+                traffic after = total_traffic();
+                m_sample.messages.sent_bytes = after.sent_bytes - m_traffic_before.sent_bytes;
+                m_sample.messages.received_bytes = after.received_bytes - m_traffic_before.received_bytes;
+                m_sample.messages.wait_time = after.wait_time - m_traffic_before.wait_time;
+                m_samples.push_back(m_sample);
+            }
+
+            void check_num_stores(size_t num_stores) const {
+                if (m_max_stores < num_stores)
+                    throw std::runtime_error("Too many data stores to be exchanged: " + std::to_string(num_stores) +
+                                             " instead of the maximum allowed, which is " +
+                                             std::to_string(m_max_stores));
+            }
+
             template <typename BoundaryApply, typename ArgsTuple, uint_t... Ids>
             static void call_apply(
                 BoundaryApply boundary_apply, ArgsTuple const &args, std::integer_sequence<uint_t, Ids...>) {
@@ -219,6 +580,22 @@ namespace gridtools {
                 /* do nothing for a pure data_store*/
             }
 
+            template <typename BCApply, uint_t... Ids>
+            auto make_task(BCApply const &bcapply, std::integer_sequence<uint_t, Ids...>) const {
+                return make_boundary<typename CTraits::comm_arch_type>(
+                    m_halos, bcapply.boundary_to_apply(), make_proc_grid_predicate(m_he->comm()))
+                    .make_task(std::get<Ids>(bcapply.stores())...);
+            }
+
+            template <typename BCApply>
+            auto make_tasks(BCApply const &bcapply) const {
+                if constexpr (is_bound_bc<BCApply>::value)
+                    return std::make_tuple(make_task(bcapply,
+                        std::make_integer_sequence<uint_t, std::tuple_size_v<typename BCApply::stores_type>>{}));
+                else
+                    return std::tuple<>();
+            }
+
             template <typename FirstJob>
             static auto collect_stores(
                 FirstJob const &firstjob, std::enable_if_t<is_bound_bc<FirstJob>::value, void *> = nullptr) {
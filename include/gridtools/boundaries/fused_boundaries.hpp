@@ -0,0 +1,174 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cassert>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../common/array.hpp"
+#include "../common/defs.hpp"
+#include "../common/halo_descriptor.hpp"
+#include "../common/hymap.hpp"
+#include "../gcl/low_level/arch.hpp"
+#include "../stencil/common/dim.hpp"
+#include "apply.hpp"
+#include "bound_bc.hpp"
+#include "boundary.hpp"
+
+/** \ingroup Boundary-Conditions
+ * @{
+ */
+
+/**
+ *  Boundary conditions fused into the stencil sweep
+ *  ------------------------------------------------
+ *
+ *  `with_boundaries(backend, halos, bind_bc(bc, stores...)...)` is a stencil backend which runs the computation with
+ *  `backend` and applies the bound boundary conditions to the halos described by `halos`, as `boundary::apply` would
+ *  after `stencil::run`. The compute domain of the grid passed to `stencil::run` must be the one of `halos`.
+ *
+ *  The host backends which report the units of work they compute (`cpu_kfirst` and `cpu_ifirst`) apply the boundary
+ *  conditions right after a unit, to the part of the halos adjacent to it: the units on the edges of the compute
+ *  domain write the strips of the halos along their side (and the corners), every unit writes the k-halos above and
+ *  below it. Hence the halos are written while the nearby data is still in the cache, instead of in a separate pass.
+ *  The boundary conditions of a unit are applied in the order they are bound. The other backends apply them in a
+ *  separate pass after the computation.
+ *
+ *  Since the units run concurrently, the stencil must not read the halos of the fields written by the boundary
+ *  conditions (which the separate pass would overwrite anyway), and the boundary conditions may read only the points
+ *  of the unit and its halos, as the usual ones (value, zero, copy) do.
+ */
+
+namespace gridtools {
+    namespace boundaries {
+        namespace fused_boundaries_impl_ {
+            template <class Job, size_t... Is>
+            auto make_views(Job const &job, std::index_sequence<Is...>) {
+                return std::make_tuple(std::get<Is>(job.stores())->target_view()...);
+            }
+
+            template <class Job>
+            auto make_views(Job const &job) {
+                return make_views(job, std::make_index_sequence<std::tuple_size_v<typename Job::stores_type>>());
+            }
+
+            // the part of the halo descriptor of a dimension which belongs to the unit [begin, begin + size)
+            inline halo_descriptor restrict_halo(halo_descriptor const &hd, int_t begin, int_t size) {
+                int_t length = hd.end() + 1 - hd.begin();
+                return halo_descriptor(begin == 0 ? hd.minus() : 0,
+                    begin + size == length ? hd.plus() : 0,
+                    hd.begin() + begin,
+                    hd.begin() + begin + size - 1,
+                    hd.total_length());
+            }
+
+            template <class Jobs, class Views>
+            struct epilogue_f {
+                array<halo_descriptor, 3> const &m_halos;
+                Jobs const &m_jobs;
+                Views const &m_views;
+
+                void operator()(
+                    int_t i_begin, int_t i_size, int_t j_begin, int_t j_size, int_t k_begin, int_t k_size) const {
+                    array<halo_descriptor, 3> halos = {restrict_halo(m_halos[0], i_begin, i_size),
+                        restrict_halo(m_halos[1], j_begin, j_size),
+                        restrict_halo(m_halos[2], k_begin, k_size)};
+                    apply(halos, std::make_index_sequence<std::tuple_size_v<Jobs>>());
+                }
+
+              private:
+                template <size_t... Is>
+                void apply(array<halo_descriptor, 3> const &halos, std::index_sequence<Is...>) const {
+                    (std::apply(
+                         [&](auto const &...views) {
+                             auto bc = std::get<Is>(m_jobs).boundary_to_apply();
+                             boundary_apply<decltype(bc)>(halos, bc).make_task(views...).apply_serial();
+                         },
+                         std::get<Is>(m_views)),
+                        ...);
+                }
+            };
+
+            template <class Backend, class Spec, class Grid, class DataStores, class Epilogue, class = void>
+            struct has_block_epilogue : std::false_type {};
+
+            template <class Backend, class Spec, class Grid, class DataStores, class Epilogue>
+            struct has_block_epilogue<Backend,
+                Spec,
+                Grid,
+                DataStores,
+                Epilogue,
+                std::void_t<decltype(gridtools_backend_entry_point(std::declval<Backend const &>(),
+                    Spec(),
+                    std::declval<Grid const &>(),
+                    std::declval<DataStores>(),
+                    std::declval<Epilogue const &>()))>> : std::true_type {};
+
+            template <class Arch, class Backend, class... Jobs>
+            struct fused_backend {
+                Backend m_backend;
+                array<halo_descriptor, 3> m_halos;
+                std::tuple<Jobs...> m_jobs;
+
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(
+                    fused_backend const &be, Spec spec, Grid const &grid, DataStores data_stores) {
+                    auto origin = grid.origin();
+                    auto const &halos = be.m_halos;
+                    assert(at_key<stencil::dim::i>(origin) == (int_t)halos[0].begin());
+                    assert(at_key<stencil::dim::j>(origin) == (int_t)halos[1].begin());
+                    assert(at_key<stencil::dim::k>(origin) == (int_t)halos[2].begin());
+                    assert(grid.i_size() == (int_t)(halos[0].end() + 1 - halos[0].begin()));
+                    assert(grid.j_size() == (int_t)(halos[1].end() + 1 - halos[1].begin()));
+                    assert((int_t)grid.k_size() == (int_t)(halos[2].end() + 1 - halos[2].begin()));
+                    (void)origin;
+
+                    // the views are made before the computation, which may run in several threads
+                    auto views = std::apply(
+                        [](auto const &...jobs) { return std::make_tuple(make_views(jobs)...); }, be.m_jobs);
+                    using epilogue_t = epilogue_f<std::tuple<Jobs...>, decltype(views)>;
+                    if constexpr (has_block_epilogue<Backend, Spec, Grid, DataStores, epilogue_t>::value) {
+                        gridtools_backend_entry_point(
+                            be.m_backend, spec, grid, std::move(data_stores), epilogue_t{halos, be.m_jobs, views});
+                    } else {
+                        gridtools_backend_entry_point(be.m_backend, spec, grid, std::move(data_stores));
+                        std::apply(
+                            [&](auto const &...jobs) {
+                                (std::apply([&](auto... stores) { make_boundary<Arch>(halos, jobs.boundary_to_apply())
+                                                                      .apply(stores...); },
+                                     jobs.stores()),
+                                    ...);
+                            },
+                            be.m_jobs);
+                    }
+                }
+            };
+
+            /**
+             * @brief Makes a stencil backend which runs `backend` and applies the boundary conditions of the jobs
+             * (made with gridtools::boundaries::bind_bc) to the halos described by `halos`.
+             *
+             * \tparam Arch The GCL architecture of the separate pass, used by the backends that do not fuse it
+             */
+            template <class Arch = gcl::cpu, class Backend, class... Jobs>
+            fused_backend<Arch, Backend, Jobs...> with_boundaries(
+                Backend backend, array<halo_descriptor, 3> const &halos, Jobs const &...jobs) {
+                static_assert(std::conjunction<is_bound_bc<Jobs>...>::value,
+                    "The jobs of with_boundaries must be made with bind_bc.");
+                return {std::move(backend), halos, std::tuple<Jobs...>(jobs...)};
+            }
+        } // namespace fused_boundaries_impl_
+        using fused_boundaries_impl_::with_boundaries;
+    } // namespace boundaries
+} // namespace gridtools
+
+/** @} */
@@ -0,0 +1,85 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+/**
+ *  Background worker thread
+ *  ------------------------
+ *
+ *  `async_worker` owns a thread that runs the submitted tasks one after the other, in the order of submission.
+ *  `shutdown()` runs the pending tasks and joins the thread; submitting afterwards throws. The destructor shuts down.
+ *  The tasks must not throw.
+ */
+
+namespace gridtools {
+    class async_worker {
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_stopped = false;
+        std::thread m_thread;
+
+        void run() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this] { return m_stopped || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+      public:
+        async_worker() : m_thread([this] { run(); }) {}
+
+        async_worker(async_worker const &) = delete;
+        async_worker &operator=(async_worker const &) = delete;
+
+        ~async_worker() { shutdown(); }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stopped)
+                    throw std::runtime_error("the worker has been shut down");
+                m_tasks.push_back(std::move(task));
+            }
+            m_cv.notify_one();
+        }
+
+        void shutdown() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_cv.notify_one();
+            if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+                m_thread.join();
+        }
+
+        bool is_shut_down() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stopped;
+        }
+    };
+} // namespace gridtools
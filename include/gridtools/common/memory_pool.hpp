@@ -0,0 +1,295 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+/**
+ *  Process-wide memory pool
+ *  ------------------------
+ *
+ *  `memory_pool_allocate(impl, size)` returns a buffer of at least `size` units obtained from the upstream
+ *  allocation function `impl`, which takes a size and returns a `std::unique_ptr` (like the allocation functions
+ *  accepted by `sid::allocator`). The returned `std::unique_ptr` does not release the buffer on destruction but
+ *  hands it back to the pool.
+ *
+ *  There is one pool per upstream allocator, shared by all threads of the process. Only the allocators whose
+ *  identity is known are pooled: the stateless function objects, with one pool per type, and the function pointers,
+ *  with one pool per function. Any other allocator, e.g. a functor holding a device or a stream, could not tell its
+ *  buffers from those of another instance of the same type, hence `memory_pool_allocate` forwards it to the upstream
+ *  allocator directly. Requested sizes are rounded up to size classes (eight classes per power of two) such that
+ *  requests of similar size can reuse each other's buffers. The waste is bounded by 12.5% of the requested size.
+ *
+ *  Data stores, `sid::cached_allocator` and `reduction::make_reducible` allocate through the pool. Hence the
+ *  hugepage-backed host storages (`cpu_ifirst`) and temporaries share a single hugepage pool.
+ *
+ *  Cached buffers are returned to the upstream allocator by `memory_pool_trim()`, or when an upstream allocation
+ *  throws: then all the pools are trimmed and the allocation is retried once before the exception is propagated.
+ *  Otherwise the cache is unbounded by default, and the memory freed by the data stores stays reserved for the
+ *  process: the applications sharing the memory with other libraries (e.g. the device memory with CUDA libraries or
+ *  MPI) must call `memory_pool_trim()`, or bound the bytes cached by each pool with
+ *  `memory_pool_set_cache_limit(bytes)`, beyond which the freed buffers are returned to the upstream allocator.
+ *  `memory_pool_statistics()` reports the counters accumulated over all pools.
+ */
+
+namespace gridtools {
+    struct memory_pool_stats {
+        std::size_t current_bytes = 0; // bytes obtained from the upstream allocators (in use and cached)
+        std::size_t peak_bytes = 0;    // maximum of current_bytes since the last reset
+        std::size_t cached_bytes = 0;  // bytes held by the pools, ready for reuse
+        std::size_t hits = 0;          // allocations served from the cache
+        std::size_t misses = 0;        // allocations forwarded to the upstream allocators
+        std::size_t page_faults = 0;   // page faults of the process since the last reset
+
+        double hit_rate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.; }
+    };
+
+    namespace memory_pool_impl_ {
+        /**
+         * @brief Rounds `size` up to the next size class: sizes up to 8 are exact, above there are 8 classes per
+         * power of two.
+         */
+        inline std::size_t size_class(std::size_t size) {
+            if (size <= 8)
+                return size;
+            std::size_t log = 0;
+            for (std::size_t i = size; i >>= 1;)
+                ++log;
+            std::size_t step = std::size_t(1) << (log - 3);
+            return (size + step - 1) / step * step;
+        }
+
+        inline std::size_t page_faults() {
+#ifdef __linux__
+            rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0)
+                return usage.ru_minflt + usage.ru_majflt;
+#endif
+            return 0;
+        }
+
+        struct pool_base {
+            virtual void trim() = 0;
+            virtual void add_stats(memory_pool_stats &) const = 0;
+            virtual void reset_stats() = 0;
+
+          protected:
+            ~pool_base() = default;
+        };
+
+        struct registry {
+            std::mutex m_mutex;
+            std::vector<pool_base *> m_pools;
+            std::size_t m_page_faults_offset = page_faults();
+            std::atomic<std::size_t> m_cache_limit{std::numeric_limits<std::size_t>::max()}; // bytes per pool
+
+            // never destroyed, as buffers may be released to the pools during static destruction
+            static registry &instance() {
+                static registry *res = new registry();
+                return *res;
+            }
+        };
+
+        inline void trim_all() {
+            auto &reg = registry::instance();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            for (auto *pool : reg.m_pools)
+                pool->trim();
+        }
+
+        // the allocators which are pooled, see the header comment
+        template <class Impl>
+        constexpr bool is_poolable_v = std::is_empty_v<Impl> || std::is_pointer_v<Impl>;
+
+        template <class Impl, class Ptr = decltype(std::declval<Impl const>()(std::size_t{}))>
+        class pool;
+
+        template <class Impl, class T, class Deleter>
+        class pool<Impl, std::unique_ptr<T, Deleter>> final : pool_base {
+            using ptr_t = std::unique_ptr<T, Deleter>;
+
+            mutable std::mutex m_mutex;
+            std::map<std::size_t, std::vector<ptr_t>> m_cache;
+            memory_pool_stats m_stats;
+
+            void release(std::size_t size, ptr_t ptr) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_stats.cached_bytes + size * sizeof_unit() > registry::instance().m_cache_limit) {
+                    // the cache would exceed its limit, the buffer goes to the upstream deleter outside of the lock
+                    m_stats.current_bytes -= size * sizeof_unit();
+                    lock.unlock();
+                    ptr.reset();
+                    return;
+                }
+                m_cache[size].push_back(std::move(ptr));
+                m_stats.cached_bytes += size * sizeof_unit();
+            }
+
+            pool() {
+                auto &reg = registry::instance();
+                std::lock_guard<std::mutex> lock(reg.m_mutex);
+                reg.m_pools.push_back(this);
+            }
+
+          public:
+            struct deleter_f {
+                using pointer = typename ptr_t::pointer;
+                Deleter m_deleter;
+                pool *m_pool;
+                std::size_t m_size;
+
+                void operator()(pointer ptr) const { m_pool->release(m_size, ptr_t(ptr, m_deleter)); }
+            };
+            using pooled_ptr_t = std::unique_ptr<T, deleter_f>;
+
+            static constexpr std::size_t sizeof_unit() {
+                if constexpr (std::is_void_v<std::remove_extent_t<T>>)
+                    return 1;
+                else
+                    return sizeof(std::remove_extent_t<T>);
+            }
+
+            // never destroyed, as buffers may be released during static destruction
+            static pool &instance(Impl const &impl) {
+                if constexpr (std::is_pointer_v<Impl>) {
+                    static auto *pools = new std::map<Impl, pool *>();
+                    static std::mutex mutex;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pool *&res = (*pools)[impl];
+                    if (!res)
+                        res = new pool();
+                    return *res;
+                } else {
+                    static pool *res = new pool();
+                    return *res;
+                }
+            }
+
+            pooled_ptr_t allocate(Impl const &impl, std::size_t size) {
+                size = size_class(size);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto it = m_cache.find(size);
+                    if (it != m_cache.end() && !it->second.empty()) {
+                        ptr_t ptr = std::move(it->second.back());
+                        it->second.pop_back();
+                        m_stats.cached_bytes -= size * sizeof_unit();
+                        ++m_stats.hits;
+                        return {ptr.release(), {ptr.get_deleter(), this, size}};
+                    }
+                }
+                ptr_t ptr;
+                try {
+                    ptr = impl(size);
+                } catch (...) {
+                    // the buffers cached by the pools may be the memory that is missing, release them and retry once
+                    trim_all();
+                    ptr = impl(size);
+                }
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_stats.misses;
+                m_stats.current_bytes += size * sizeof_unit();
+                m_stats.peak_bytes = std::max(m_stats.peak_bytes, m_stats.current_bytes);
+                return {ptr.release(), {ptr.get_deleter(), this, size}};
+            }
+
+            void trim() override {
+                std::map<std::size_t, std::vector<ptr_t>> cache;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    cache.swap(m_cache);
+                    m_stats.current_bytes -= m_stats.cached_bytes;
+                    m_stats.cached_bytes = 0;
+                }
+                // the upstream deleters are called here, outside of the lock
+            }
+
+            void add_stats(memory_pool_stats &res) const override {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                res.current_bytes += m_stats.current_bytes;
+                res.peak_bytes += m_stats.peak_bytes;
+                res.cached_bytes += m_stats.cached_bytes;
+                res.hits += m_stats.hits;
+                res.misses += m_stats.misses;
+            }
+
+            void reset_stats() override {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.peak_bytes = m_stats.current_bytes;
+                m_stats.hits = 0;
+                m_stats.misses = 0;
+            }
+        };
+    } // namespace memory_pool_impl_
+
+    /**
+     * @brief Allocates a buffer of at least `size` units through the process-wide pool associated with `impl`, or
+     * directly with `impl` if it is not pooled (see the header comment).
+     */
+    template <class Impl>
+    auto memory_pool_allocate(Impl const &impl, std::size_t size) {
+        if constexpr (memory_pool_impl_::is_poolable_v<Impl>)
+            return memory_pool_impl_::pool<Impl>::instance(impl).allocate(impl, size);
+        else
+            return impl(size);
+    }
+
+    /**
+     * @brief Bounds the bytes cached by each pool, the buffers freed beyond it are returned to the upstream allocator.
+     */
+    inline void memory_pool_set_cache_limit(std::size_t bytes) {
+        memory_pool_impl_::registry::instance().m_cache_limit = bytes;
+    }
+
+    /**
+     * @brief Returns all cached buffers of all pools to their upstream allocators.
+     */
+    inline void memory_pool_trim() { memory_pool_impl_::trim_all(); }
+
+    /**
+     * @brief Returns the counters accumulated over all pools.
+     *
+     * Note that `peak_bytes` is the sum of the peaks of the individual pools.
+     */
+    inline memory_pool_stats memory_pool_statistics() {
+        auto &reg = memory_pool_impl_::registry::instance();
+        std::lock_guard<std::mutex> lock(reg.m_mutex);
+        memory_pool_stats res;
+        for (auto *pool : reg.m_pools)
+            pool->add_stats(res);
+        res.page_faults = memory_pool_impl_::page_faults() - reg.m_page_faults_offset;
+        return res;
+    }
+
+    /**
+     * @brief Resets hit/miss and page fault counters, and the peak to the current number of bytes.
+     */
+    inline void memory_pool_reset_statistics() {
+        auto &reg = memory_pool_impl_::registry::instance();
+        std::lock_guard<std::mutex> lock(reg.m_mutex);
+        for (auto *pool : reg.m_pools)
+            pool->reset_stats();
+        reg.m_page_faults_offset = memory_pool_impl_::page_faults();
+    }
+} // namespace gridtools
@@ -9,10 +9,13 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 #include "../common/halo_descriptor.hpp"
 #include "../common/layout_map.hpp"
+#include "high_level/compression.hpp"
 #include "high_level/descriptor_generic_manual.hpp"
 #include "high_level/descriptors.hpp"
 #include "high_level/descriptors_manual_gpu.hpp"
@@ -186,6 +189,17 @@ namespace gridtools {
 
             halo_exchange_dynamic_ut(halo_exchange_dynamic_ut const &) {}
 
+            // the 3D slices of the fields, see pack with slices
+            static std::vector<DataType *> slices_of(
+                std::vector<DataType *> const &fields, int slices, std::ptrdiff_t stride) {
+                std::vector<DataType *> res;
+                res.reserve(fields.size() * slices);
+                for (DataType *field : fields)
+                    for (int s = 0; s < slices; ++s)
+                        res.push_back(field + s * stride);
+                return res;
+            }
+
           public:
             /** constructor that takes the periodicity (mathich the \link
                 boollist_concept \endlink concept, and the MPI CART
@@ -208,12 +222,68 @@ namespace gridtools {
             */
             pattern_type const &pattern() const { return hd.pattern(); }
 
+            /** Resets the communication statistics of the pattern, see Halo_Exchange_3D::statistics.
+             */
+            void reset_statistics() { hd.m_haloexch.reset_statistics(); }
+
             /**
                Function to setup internal data structures for data exchange and preparing eventual underlying layers
 
                \param max_fields_n Maximum number of data fields that will be passed to the communication functions
+               \param persistent_requests Whether the communication uses persistent MPI requests, which are set up
+               once for a fixed number of fields (see Halo_Exchange_3D::use_persistent_requests)
+            */
+            void setup(int max_fields_n, bool persistent_requests = false) {
+                hd.setup(max_fields_n);
+                hd.m_haloexch.use_persistent_requests(persistent_requests);
+            }
+
+            /**
+               Function to enable the intra-node transport through MPI-3 shared memory windows, see
+               Halo_Exchange_3D::use_shared_memory. Must be called by all the processes before setup.
+
+               \param value true to enable the shared memory transport
+            */
+            void use_shared_memory(bool value) { hd.m_haloexch.use_shared_memory(value); }
+
+            /**
+               Function to select the transport through a neighborhood collective, see
+               Halo_Exchange_3D::use_neighborhood_collectives. Must be called by all the processes.
+
+               \param value true to exchange the messages with a neighborhood collective
+            */
+            void use_neighborhood_collectives(bool value) { hd.m_haloexch.use_neighborhood_collectives(value); }
+
+            /**
+               Function to select the exchange of the fields with MPI derived datatypes, without packing them into
+               buffers, see hndlr_dynamic_ut::use_derived_datatypes. Available for the cpu architecture only. Must be
+               called by all the processes after setup.
+
+               \param value true to exchange the fields with derived datatypes
+            */
+            void use_derived_datatypes(bool value) { hd.use_derived_datatypes(value); }
+
+            /**
+               Function to select whether the exchanges are driven by a progress thread, which unpacks the data of each
+               neighbor into the packed fields as soon as it arrives, see hndlr_dynamic_ut::use_progress_thread.
+               Available for the cpu architecture only.
+
+               \param value true to use a progress thread
+            */
+            void use_progress_thread(bool value) { hd.use_progress_thread(value); }
+
+            /**
+               Function to enable the compression of the messages, configured per field, see
+               hndlr_dynamic_ut::use_compression. Available for the cpu architecture only. Must be called by all the
+               processes after setup.
+
+               \param per_field Compression of each field in the order in which they are packed, empty to disable it
             */
-            void setup(int max_fields_n) { hd.setup(max_fields_n); }
+            void use_compression(std::vector<halo_compression> per_field) { hd.use_compression(std::move(per_field)); }
+
+            /** Returns the ratio of the bytes of the packed messages to the bytes sent with the compression.
+             */
+            double compression_ratio() const { return hd.compression_ratio(); }
 
             /**
                Function to register halos with the pattern. The registration
@@ -275,6 +345,34 @@ namespace gridtools {
             */
             void unpack(std::vector<DataType *> const &fields) { hd.unpack(fields); }
 
+            /**
+               Function to pack fields with dimensions beyond the three of the halos, such as tracers or components.
+               Each field is made of `slices` 3D fields, described by the halos, `stride` elements apart, hence the
+               extra dimensions must have the largest strides; several of them are passed as one with the product of
+               their lengths when they are contiguous. The slices of all the fields are aggregated into one message
+               per neighbor, which replaces an exchange per slice. The process grid is still 3D, and setup must be
+               called with the total number of slices.
+
+               \param[in] fields vector with data fields pointers to be packed from
+               \param[in] slices Number of 3D slices of each field
+               \param[in] stride Distance between consecutive slices, in elements
+            */
+            void pack(std::vector<DataType *> const &fields, int slices, std::ptrdiff_t stride) {
+                hd.pack(slices_of(fields, slices, stride));
+            }
+
+            /**
+               Function to unpack received data into fields with dimensions beyond the three of the halos, see pack
+               with slices.
+
+               \param[in] fields vector with data fields pointers to be unpacked into
+               \param[in] slices Number of 3D slices of each field
+               \param[in] stride Distance between consecutive slices, in elements
+            */
+            void unpack(std::vector<DataType *> const &fields, int slices, std::ptrdiff_t stride) {
+                hd.unpack(slices_of(fields, slices, stride));
+            }
+
             /**
                function to trigger data exchange
 
@@ -303,6 +401,29 @@ namespace gridtools {
             */
             void wait() { hd.wait(); }
 
+            /**
+               function to exchange the halos of the fields in a pipeline, in place of pack(), start_exchange(), wait()
+               and unpack(): the message to each neighbor is sent as soon as it is packed and the data of each
+               neighbor is unpacked as soon as it arrives, see hndlr_dynamic_ut::exchange_pipelined. Available for the
+               cpu architecture only.
+
+               \param[in] fields vector with data fields pointers to be exchanged
+            */
+            void exchange_pipelined(std::vector<DataType *> const &fields) { hd.exchange_pipelined(fields); }
+
+            template <typename... FIELDS>
+            void exchange_pipelined(FIELDS *..._fields) {
+                hd.exchange_pipelined(_fields...);
+            }
+
+            /**
+               function to exchange the halos of fields with dimensions beyond the three of the halos in a pipeline,
+               see pack with slices and exchange_pipelined.
+            */
+            void exchange_pipelined(std::vector<DataType *> const &fields, int slices, std::ptrdiff_t stride) {
+                hd.exchange_pipelined(slices_of(fields, slices, stride));
+            }
+
             grid_type const &comm() const { return hd.comm(); }
         };
 
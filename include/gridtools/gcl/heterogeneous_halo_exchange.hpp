@@ -0,0 +1,216 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include "../common/array.hpp"
+#include "../common/defs.hpp"
+#include "../common/halo_descriptor.hpp"
+#include "low_level/Halo_Exchange_3D.hpp"
+#include "low_level/proc_grids_3D.hpp"
+
+/**
+ *  Halo exchange of heterogeneous fields
+ *  -------------------------------------
+ *
+ *  `heterogeneous_halo_exchange` exchanges in a single call fields of different value types, halo widths and
+ *  layouts. The halos of all the fields directed to a neighbor are packed into one byte buffer, hence there is a
+ *  single message per neighbor and exchange. The buffers grow on demand, there is no limit on the number of fields.
+ *
+ *  A field is described by `make_halo_field(ptr, halos, strides)`, with the pointer to the element (0, 0, 0), the
+ *  halo descriptors of the three dimensions and the strides in elements, or by `make_halo_field(data_store, halos)`.
+ *  The dimensions of the fields are those of the process grid. All the processes have to pass the fields in the same
+ *  order, and with the same halo widths. The data has to be accessible from the host.
+ *
+ *  Example:
+ *
+ *    heterogeneous_halo_exchange he({true, true, false}, cart_comm);
+ *    he.exchange(make_halo_field(temperature, halos), make_halo_field(mask, mask_halos));
+ */
+
+namespace gridtools {
+    namespace gcl {
+        namespace heterogeneous_halo_exchange_impl_ {
+            template <class T>
+            struct halo_field {
+                static_assert(std::is_trivially_copyable_v<T>, "exchanged fields must be trivially copyable");
+
+                T *m_ptr;
+                array<halo_descriptor, 3> m_halos;
+                array<std::ptrdiff_t, 3> m_strides;
+
+                // the bounds of the region sent to (Inside == true) or received from the neighbor eta
+                template <bool Inside>
+                void bounds(array<int, 3> const &eta, int (&lo)[3], int (&hi)[3]) const {
+                    for (int d = 0; d < 3; ++d) {
+                        lo[d] = Inside ? m_halos[d].loop_low_bound_inside(eta[d])
+                                       : m_halos[d].loop_low_bound_outside(eta[d]);
+                        hi[d] = Inside ? m_halos[d].loop_high_bound_inside(eta[d])
+                                       : m_halos[d].loop_high_bound_outside(eta[d]);
+                    }
+                }
+
+                template <bool Inside>
+                std::size_t bytes(array<int, 3> const &eta) const {
+                    int lo[3], hi[3];
+                    bounds<Inside>(eta, lo, hi);
+                    std::size_t res = sizeof(T);
+                    for (int d = 0; d < 3; ++d)
+                        res *= hi[d] >= lo[d] ? hi[d] - lo[d] + 1 : 0;
+                    return res;
+                }
+
+                // copies the region from the field to the buffer (Pack == true) or back, returns the next position
+                template <bool Pack>
+                char *copy(array<int, 3> const &eta, char *buffer) const {
+                    int lo[3], hi[3];
+                    bounds<Pack>(eta, lo, hi);
+                    if (hi[0] < lo[0])
+                        return buffer;
+                    std::size_t row = (hi[0] - lo[0] + 1) * sizeof(T);
+                    for (int k = lo[2]; k <= hi[2]; ++k)
+                        for (int j = lo[1]; j <= hi[1]; ++j) {
+                            T *ptr = m_ptr + lo[0] * m_strides[0] + j * m_strides[1] + k * m_strides[2];
+                            if (m_strides[0] == 1) {
+                                if (Pack)
+                                    std::memcpy(buffer, ptr, row);
+                                else
+                                    std::memcpy(ptr, buffer, row);
+                                buffer += row;
+                            } else {
+                                for (int i = lo[0]; i <= hi[0]; ++i, ptr += m_strides[0], buffer += sizeof(T)) {
+                                    if (Pack)
+                                        std::memcpy(buffer, ptr, sizeof(T));
+                                    else
+                                        std::memcpy(ptr, buffer, sizeof(T));
+                                }
+                            }
+                        }
+                    return buffer;
+                }
+            };
+
+            template <class T, class Strides>
+            halo_field<T> make_halo_field(T *ptr, array<halo_descriptor, 3> const &halos, Strides const &strides) {
+                return {ptr,
+                    halos,
+                    {std::ptrdiff_t(strides[0]), std::ptrdiff_t(strides[1]), std::ptrdiff_t(strides[2])}};
+            }
+
+            template <class DataStorePtr>
+            auto make_halo_field(DataStorePtr const &ds, array<halo_descriptor, 3> const &halos)
+                -> decltype(make_halo_field(ds->get_target_ptr(), halos, ds->strides())) {
+                return make_halo_field(ds->get_target_ptr(), halos, ds->strides());
+            }
+
+            class heterogeneous_halo_exchange {
+              public:
+                typedef MPI_3D_process_grid_t<3> grid_type;
+
+              private:
+                typedef Halo_Exchange_3D<grid_type> pattern_type;
+                typedef typename pattern_type::translate_type translate;
+
+                pattern_type m_pattern;
+                std::vector<char> m_send_buffers[27];
+                std::vector<char> m_recv_buffers[27];
+
+                bool m_has_neighbor[27];
+
+                static array<int, 3> eta(int n) { return {n % 3 - 1, n / 3 % 3 - 1, n / 9 - 1}; }
+
+                bool has_neighbor(array<int, 3> const &eta) const {
+                    return m_has_neighbor[translate()(eta[0], eta[1], eta[2])];
+                }
+
+              public:
+                /**
+                    \param[in] period Periodicity of the dimensions
+                    \param[in] comm MPI CART communicator with dimension 3
+                */
+                heterogeneous_halo_exchange(grid_type::period_type const &period, MPI_Comm comm)
+                    : m_pattern(grid_type(period, comm)) {
+                    for (int n = 0; n < 27; ++n) {
+                        auto e = eta(n);
+                        m_has_neighbor[translate()(e[0], e[1], e[2])] =
+                            (e[0] || e[1] || e[2]) && proc_grid().proc(e[0], e[1], e[2]) != -1;
+                    }
+                }
+
+                grid_type const &proc_grid() const { return m_pattern.proc_grid(); }
+
+                /**
+                    Packs the fields, growing the buffers if needed, and starts the communication.
+                */
+                template <class... Fields>
+                void start_exchange(Fields const &...fields) {
+                    for (int n = 0; n < 27; ++n) {
+                        auto e = eta(n);
+                        auto &send = m_send_buffers[translate()(e[0], e[1], e[2])];
+                        auto &recv = m_recv_buffers[translate()(e[0], e[1], e[2])];
+                        std::size_t send_size = 0, recv_size = 0;
+                        if (has_neighbor(e)) {
+                            send_size = (std::size_t(0) + ... + fields.template bytes<true>(e));
+                            recv_size = (std::size_t(0) + ... + fields.template bytes<false>(e));
+                        }
+                        if (send.size() < send_size)
+                            send.resize(send_size);
+                        if (recv.size() < recv_size)
+                            recv.resize(recv_size);
+                        m_pattern.register_send_to_buffer(send.data(), send_size, e[0], e[1], e[2]);
+                        m_pattern.register_receive_from_buffer(recv.data(), recv_size, e[0], e[1], e[2]);
+                    }
+#pragma omp parallel for schedule(dynamic)
+                    for (int n = 0; n < 27; ++n) {
+                        auto e = eta(n);
+                        if (!has_neighbor(e))
+                            continue;
+                        char *it = m_send_buffers[translate()(e[0], e[1], e[2])].data();
+                        ((it = fields.template copy<true>(e, it)), ...);
+                    }
+                    m_pattern.start_exchange();
+                }
+
+                /**
+                    Waits for the communication and unpacks the fields, which must be the same passed to
+                    start_exchange.
+                */
+                template <class... Fields>
+                void wait(Fields const &...fields) {
+                    m_pattern.wait();
+#pragma omp parallel for schedule(dynamic)
+                    for (int n = 0; n < 27; ++n) {
+                        auto e = eta(n);
+                        if (!has_neighbor(e))
+                            continue;
+                        char *it = m_recv_buffers[translate()(e[0], e[1], e[2])].data();
+                        ((it = fields.template copy<false>(e, it)), ...);
+                    }
+                }
+
+                template <class... Fields>
+                void exchange(Fields const &...fields) {
+                    start_exchange(fields...);
+                    wait(fields...);
+                }
+            };
+        } // namespace heterogeneous_halo_exchange_impl_
+
+        using heterogeneous_halo_exchange_impl_::halo_field;
+        using heterogeneous_halo_exchange_impl_::heterogeneous_halo_exchange;
+        using heterogeneous_halo_exchange_impl_::make_halo_field;
+    } // namespace gcl
+} // namespace gridtools
@@ -0,0 +1,248 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace gridtools {
+    namespace gcl {
+        /**
+           Compression of the data of a field in the halo messages. The lossless compression shuffles the bytes of
+           the values (the first bytes of all the values, then the second ones, etc.), such that the slowly varying
+           bytes of smooth fields are contiguous, and compresses them with a fast LZ77 coder. The lossy compression
+           truncates the mantissas of floating point values to the bits needed for the relative error bound before
+           the lossless compression, which then finds longer repetitions. The values of other types are compressed
+           without loss.
+        */
+        struct halo_compression {
+            enum class method { none, lossless, lossy };
+
+            method kind = method::none;
+            // bound of the relative error of each value with the lossy method
+            double max_relative_error = 0;
+
+            static halo_compression lossless() { return {method::lossless, 0}; }
+
+            static halo_compression lossy(double max_relative_error) { return {method::lossy, max_relative_error}; }
+        };
+
+        namespace compression_impl_ {
+            enum encoding : unsigned char { raw, shuffled_lz };
+
+            // each compressed segment starts with the encoding and the size of the payload
+            constexpr std::size_t header_size = 8;
+
+            inline void put_varint(unsigned char *&out, std::size_t value) {
+                for (; value >= 128; value >>= 7)
+                    *out++ = (unsigned char)(value | 128);
+                *out++ = (unsigned char)value;
+            }
+
+            inline std::size_t get_varint(unsigned char const *&in) {
+                std::size_t value = 0;
+                for (int shift = 0;; shift += 7) {
+                    unsigned char byte = *in++;
+                    value |= std::size_t(byte & 127) << shift;
+                    if (byte < 128)
+                        return value;
+                }
+            }
+
+            /*
+              LZ77 coder. The output is a sequence of a literal run (varint length, bytes) followed by a match
+              (varint length - min_match, 16 bit offset), ended by a literal run. The matches are found through a
+              hash table of the last position of the 4 byte sequences. Returns the size of the output, or 0 if it
+              does not fit in the capacity.
+            */
+            inline std::size_t lz_compress(
+                unsigned char const *src, std::size_t size, unsigned char *dst, std::size_t capacity) {
+                constexpr std::size_t min_match = 4;
+                constexpr std::size_t max_offset = 65535;
+                constexpr int hash_bits = 12;
+                constexpr std::uint32_t empty = std::numeric_limits<std::uint32_t>::max();
+                std::uint32_t table[1 << hash_bits];
+                std::fill(std::begin(table), std::end(table), empty);
+                auto hash = [&](std::size_t i) {
+                    std::uint32_t value;
+                    std::memcpy(&value, src + i, sizeof(value));
+                    return (value * 2654435761u) >> (32 - hash_bits);
+                };
+                unsigned char *out = dst;
+                std::size_t anchor = 0;
+                // emits the literals from the anchor to literals_end, and the match if any
+                auto emit = [&](std::size_t literals_end, std::size_t length, std::size_t offset) {
+                    constexpr std::size_t max_varint = (sizeof(std::size_t) * 8 + 6) / 7;
+                    std::size_t literals = literals_end - anchor;
+                    if (capacity - std::size_t(out - dst) < literals + 2 * max_varint + 2)
+                        return false;
+                    put_varint(out, literals);
+                    std::memcpy(out, src + anchor, literals);
+                    out += literals;
+                    if (length) {
+                        put_varint(out, length - min_match);
+                        *out++ = (unsigned char)(offset & 255);
+                        *out++ = (unsigned char)(offset >> 8);
+                    }
+                    return true;
+                };
+                for (std::size_t i = 0; i + min_match <= size;) {
+                    std::uint32_t &entry = table[hash(i)];
+                    std::size_t candidate = entry;
+                    entry = (std::uint32_t)i;
+                    if (candidate == empty || i - candidate > max_offset ||
+                        std::memcmp(src + candidate, src + i, min_match)) {
+                        ++i;
+                        continue;
+                    }
+                    std::size_t length = min_match;
+                    while (i + length < size && src[candidate + length] == src[i + length])
+                        ++length;
+                    if (!emit(i, length, i - candidate))
+                        return 0;
+                    i += length;
+                    anchor = i;
+                }
+                if (!emit(size, 0, 0))
+                    return 0;
+                return out - dst;
+            }
+
+            inline void lz_decompress(unsigned char const *src, std::size_t size, unsigned char *dst) {
+                unsigned char const *end = src + size;
+                while (true) {
+                    std::size_t literals = get_varint(src);
+                    std::memcpy(dst, src, literals);
+                    dst += literals;
+                    src += literals;
+                    if (src == end)
+                        return;
+                    std::size_t length = get_varint(src) + 4;
+                    std::size_t offset = src[0] | std::size_t(src[1]) << 8;
+                    src += 2;
+                    // the match may overlap with the bytes it produces
+                    for (std::size_t k = 0; k != length; ++k, ++dst)
+                        *dst = *(dst - offset);
+                }
+            }
+
+            // the number of mantissa bits which bound the relative error of the truncation by max_relative_error
+            template <class T>
+            int kept_mantissa_bits(double max_relative_error) {
+                constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+                if (!(max_relative_error > 0))
+                    return mantissa_bits;
+                return std::clamp((int)std::ceil(-std::log2(max_relative_error)), 0, mantissa_bits);
+            }
+
+            // clears the mantissa bits of value beyond the kept ones
+            template <class T>
+            T truncate(T value, int kept_bits) {
+                using bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+                if (kept_bits >= mantissa_bits || !std::isfinite(value))
+                    return value;
+                bits_t bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                bits &= ~((bits_t(1) << (mantissa_bits - kept_bits)) - 1);
+                std::memcpy(&value, &bits, sizeof(T));
+                return value;
+            }
+
+            inline unsigned char *write_header(unsigned char *dst, encoding e, std::size_t payload) {
+                std::uint32_t size = (std::uint32_t)payload;
+                dst[0] = e;
+                dst[1] = dst[2] = dst[3] = 0;
+                std::memcpy(dst + 4, &size, sizeof(size));
+                return dst + header_size;
+            }
+        } // namespace compression_impl_
+
+        /**
+           The size of the buffer which holds the compressed data of `bytes` bytes in the worst case.
+        */
+        inline std::size_t compressed_bound(std::size_t bytes) { return bytes + compression_impl_::header_size; }
+
+        /**
+           Compresses the n values at src into dst, which has at least compressed_bound(n * sizeof(T)) bytes, with
+           the scratch buffer provided. The data which does not compress is stored as it is.
+
+           \return the number of bytes written into dst
+        */
+        template <class T>
+        std::size_t compress(halo_compression const &config,
+            T const *src,
+            std::size_t n,
+            unsigned char *dst,
+            std::vector<unsigned char> &scratch) {
+            using namespace compression_impl_;
+            std::size_t bytes = n * sizeof(T);
+            if (config.kind != halo_compression::method::none && bytes) {
+                scratch.resize(bytes);
+                int kept_bits = 0;
+                bool lossy = false;
+                if constexpr (std::is_floating_point_v<T>) {
+                    lossy = config.kind == halo_compression::method::lossy;
+                    kept_bits = kept_mantissa_bits<T>(config.max_relative_error);
+                }
+                auto const *bytes_in = reinterpret_cast<unsigned char const *>(src);
+                for (std::size_t i = 0; i != n; ++i) {
+                    unsigned char value[sizeof(T)];
+                    std::memcpy(value, bytes_in + i * sizeof(T), sizeof(T));
+                    if constexpr (std::is_floating_point_v<T>) {
+                        if (lossy) {
+                            T truncated = truncate(src[i], kept_bits);
+                            std::memcpy(value, &truncated, sizeof(T));
+                        }
+                    }
+                    for (std::size_t b = 0; b != sizeof(T); ++b)
+                        scratch[b * n + i] = value[b];
+                }
+                std::size_t payload = lz_compress(scratch.data(), bytes, dst + header_size, bytes);
+                if (payload) {
+                    write_header(dst, shuffled_lz, payload);
+                    return header_size + payload;
+                }
+            }
+            std::memcpy(write_header(dst, raw, bytes), src, bytes);
+            return header_size + bytes;
+        }
+
+        /**
+           Decompresses the n values compressed at src into dst, with the scratch buffer provided.
+
+           \return the number of bytes read from src
+        */
+        template <class T>
+        std::size_t decompress(unsigned char const *src, T *dst, std::size_t n, std::vector<unsigned char> &scratch) {
+            using namespace compression_impl_;
+            std::uint32_t payload;
+            std::memcpy(&payload, src + 4, sizeof(payload));
+            if (src[0] == raw) {
+                std::memcpy(dst, src + header_size, payload);
+                return header_size + payload;
+            }
+            std::size_t bytes = n * sizeof(T);
+            scratch.resize(bytes);
+            lz_decompress(src + header_size, payload, scratch.data());
+            auto *bytes_out = reinterpret_cast<unsigned char *>(dst);
+            for (std::size_t i = 0; i != n; ++i)
+                for (std::size_t b = 0; b != sizeof(T); ++b)
+                    bytes_out[i * sizeof(T) + b] = scratch[b * n + i];
+            return header_size + payload;
+        }
+    } // namespace gcl
+} // namespace gridtools
@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include "../../common/array.hpp"
@@ -16,6 +18,7 @@
 #include "../low_level/proc_grids_3D.hpp"
 #include "../low_level/translate.hpp"
 #include "access.hpp"
+#include "compression.hpp"
 #include "descriptor_base.hpp"
 #include "empty_field_base.hpp"
 #include "helpers_impl.hpp"
@@ -57,38 +60,54 @@ namespace gridtools {
 
             const halo_descriptor *raw_array() const { return &(base_type::halos[0]); }
 
+            /**
+               Packs the plane k of the region to be sent to the neighbor eta, one contiguous row at a time.
+
+               \return the position next to the last packed element
+            */
+            template <typename T>
+            T *pack_plane(array<int, 3> const &eta, T const *field_ptr, int k, T *it) const {
+                int i0 = halos[0].loop_low_bound_inside(eta[0]);
+                int ni = halos[0].loop_high_bound_inside(eta[0]) - i0 + 1;
+                for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
+                     ++j, it += ni)
+                    std::copy_n(
+                        field_ptr + access(i0, j, k, halos[0].total_length(), halos[1].total_length()), ni, it);
+                return it;
+            }
+
+            /**
+               Unpacks the plane k of the region received from the neighbor eta, one contiguous row at a time.
+
+               \return the position next to the last unpacked element
+            */
+            template <typename T>
+            T const *unpack_plane(array<int, 3> const &eta, T *field_ptr, int k, T const *it) const {
+                int i0 = halos[0].loop_low_bound_outside(eta[0]);
+                int ni = halos[0].loop_high_bound_outside(eta[0]) - i0 + 1;
+                for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
+                     ++j, it += ni)
+                    std::copy_n(
+                        it, ni, field_ptr + access(i0, j, k, halos[0].total_length(), halos[1].total_length()));
+                return it;
+            }
+
             template <typename iterator_in, typename iterator_out>
             void pack(array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
+                auto *dst = reinterpret_cast<iterator_in *>(it);
                 for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]);
-                     ++k) {
-                    for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
-                         ++j) {
-                        for (int i = halos[0].loop_low_bound_inside(eta[0]);
-                             i <= halos[0].loop_high_bound_inside(eta[0]);
-                             ++i) {
-                            *(reinterpret_cast<iterator_in *>(it)) =
-                                field_ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())];
-                            reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                        }
-                    }
-                }
+                     ++k)
+                    dst = pack_plane(eta, field_ptr, k, dst);
+                it = reinterpret_cast<iterator_out *>(dst);
             }
 
             template <typename iterator_in, typename iterator_out>
             void unpack(array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
+                auto const *src = reinterpret_cast<iterator_in const *>(it);
                 for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]);
-                     ++k) {
-                    for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
-                         ++j) {
-                        for (int i = halos[0].loop_low_bound_outside(eta[0]);
-                             i <= halos[0].loop_high_bound_outside(eta[0]);
-                             ++i) {
-                            field_ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())] =
-                                *(reinterpret_cast<iterator_in *>(it));
-                            reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                        }
-                    }
-                }
+                     ++k)
+                    src = unpack_plane(eta, field_ptr, k, src);
+                it = reinterpret_cast<iterator_out *>(const_cast<iterator_in *>(src));
             }
 
             template <typename iterator>
@@ -381,6 +400,33 @@ namespace gridtools {
             array<int, static_pow3(DIMS)> send_size;
             array<int, static_pow3(DIMS)> recv_size;
 
+            /*
+              Derived datatypes mode. The regions of a field sent to (0) and received from (1) each neighbor are
+              described by subarray datatypes, made once when the mode is enabled. The messages are made of the
+              regions of all the fields, whose addresses are gathered by hindexed datatypes, remade only when the
+              fields change.
+            */
+            bool m_use_datatypes = false;
+            std::vector<MPI_Datatype> m_field_types[2];   // indexed as the neighbors by translate
+            std::vector<MPI_Datatype> m_message_types[2]; // indexed as the neighbors by translate
+            std::vector<DataType const *> m_fields;
+
+            // the fields of the last pack, unpacked by the progress thread of the pattern as their data arrives
+            std::vector<DataType const *> m_packed_fields;
+
+            /*
+              Compression of the messages, configured per field. The packed messages are compressed into the
+              compressed send buffers (0), which are sent instead, and received into the compressed receive buffers
+              (1), which are decompressed into the receive buffers before the unpacking. The neighbors served through
+              the shared memory window read the packed data as it is.
+            */
+            std::vector<halo_compression> m_compression;
+            array<std::vector<unsigned char>, static_pow3(DIMS)> m_compressed[2];
+            mutable array<std::vector<unsigned char>, static_pow3(DIMS)> m_scratch;
+            int m_max_fields = 0;
+            std::size_t m_raw_bytes = 0;        // sent since the compression is enabled
+            std::size_t m_compressed_bytes = 0; // sent since the compression is enabled
+
           public:
             typedef cpu arch_type;
             typedef descriptor_base<HaloExch> base_type;
@@ -410,7 +456,10 @@ namespace gridtools {
             explicit hndlr_dynamic_ut(typename grid_type::period_type const &c, MPI_Comm const &comm)
                 : base_type(c, comm), halo(), send_buffer{nullptr}, recv_buffer{nullptr}, send_size{0}, recv_size{0} {}
 
-            ~hndlr_dynamic_ut() { _destroy_dynamic_ut<DIMS, 0>().do_it(this); }
+            ~hndlr_dynamic_ut() {
+                free_datatypes();
+                _destroy_dynamic_ut<DIMS, 0>().do_it(this);
+            }
 
             /**
                Constructor
@@ -437,7 +486,202 @@ namespace gridtools {
 
                \param max_fields_n Maximum number of data fields that will be passed to the communication functions
             */
-            void setup(int max_fields_n) { allocation_service<this_type>()(this, max_fields_n); }
+            void setup(int max_fields_n) {
+                m_max_fields = max_fields_n;
+                allocation_service<this_type>()(this, max_fields_n);
+            }
+
+            /**
+               Function to select whether the fields are exchanged with MPI derived datatypes describing their halo
+               regions instead of through the send and receive buffers. The data is then sent from and received into
+               the memory of the fields, without the copies of packing and unpacking: pack registers the fields with
+               the pattern, hence it must precede post_receives, and unpack does nothing. Must be called after setup,
+               with the same value by all the processes, and not with the shared memory transport.
+
+               \param value true to exchange the fields with derived datatypes
+            */
+            void use_derived_datatypes(bool value) {
+                assert(!value || !base_type::m_haloexch.has_shared_send_buffers());
+                free_datatypes();
+                if (!value && !m_use_datatypes)
+                    return;
+                m_use_datatypes = value;
+                if (value)
+                    for (int d = 0; d < 2; ++d) {
+                        m_field_types[d].assign(static_pow3(DIMS), MPI_DATATYPE_NULL);
+                        m_message_types[d].assign(static_pow3(DIMS), MPI_DATATYPE_NULL);
+                    }
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            if (ii == 0 && jj == 0 && kk == 0)
+                                continue;
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            const int id = translate()(ii, jj, kk);
+                            if (value) {
+                                const array<int, 3> eta = {ii, jj, kk};
+                                auto inside = _impl::make_datatype_outin<DataType>::inside(halo.halos, eta);
+                                auto outside = _impl::make_datatype_outin<DataType>::outside(halo.halos, eta);
+                                m_field_types[0][id] = inside.second ? inside.first : MPI_DATATYPE_NULL;
+                                m_field_types[1][id] = outside.second ? outside.first : MPI_DATATYPE_NULL;
+                                // no messages until the fields are registered by pack
+                                base_type::m_haloexch.template register_datatype<true>(
+                                    MPI_DATATYPE_NULL, 0, ii_P, jj_P, kk_P);
+                                base_type::m_haloexch.template register_datatype<false>(
+                                    MPI_DATATYPE_NULL, 0, ii_P, jj_P, kk_P);
+                            } else {
+                                base_type::m_haloexch.register_send_to_buffer(send_buffer[id], 0, ii_P, jj_P, kk_P);
+                                base_type::m_haloexch.register_receive_from_buffer(
+                                    recv_buffer[id], 0, ii_P, jj_P, kk_P);
+                            }
+                        }
+                // the handles of the freed datatypes may be reused, hence the persistent requests are remade
+                if (base_type::m_haloexch.uses_persistent_requests()) {
+                    base_type::m_haloexch.use_persistent_requests(false);
+                    base_type::m_haloexch.use_persistent_requests(true);
+                }
+            }
+
+            bool uses_derived_datatypes() const { return m_use_datatypes; }
+
+            /**
+               Function to enable the compression of the messages, configured for each field in the order in which
+               they are passed to pack; the fields beyond the list are not compressed. The messages to each neighbor
+               are compressed after the packing and decompressed before the unpacking, which trades the time of the
+               (de)compression for the bytes sent, reported by the statistics of the pattern and by
+               compression_ratio. Must be called after setup, with the same configuration by all the processes, and
+               not with the derived datatypes or the neighborhood collective, which need the exact sizes of the
+               messages. An empty list disables the compression.
+
+               \param per_field Compression of each field
+            */
+            void use_compression(std::vector<halo_compression> per_field) {
+                assert(per_field.empty() || !m_use_datatypes);
+                assert(per_field.empty() || !pattern().uses_neighborhood_collectives());
+                bool was_enabled = compresses();
+                m_compression = std::move(per_field);
+                m_raw_bytes = m_compressed_bytes = 0;
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            if (ii == 0 && jj == 0 && kk == 0)
+                                continue;
+                            const int id = translate()(ii, jj, kk);
+                            if (compresses()) {
+                                m_compressed[0][id].resize(
+                                    m_max_fields * compressed_bound(send_size[id] * sizeof(DataType)));
+                                m_compressed[1][id].resize(
+                                    m_max_fields * compressed_bound(recv_size[id] * sizeof(DataType)));
+                            } else if (was_enabled) {
+                                typedef proc_layout map_type;
+                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                                base_type::m_haloexch.register_send_to_buffer(send_buffer[id], 0, ii_P, jj_P, kk_P);
+                                base_type::m_haloexch.register_receive_from_buffer(
+                                    recv_buffer[id], 0, ii_P, jj_P, kk_P);
+                                m_compressed[0][id].clear();
+                                m_compressed[1][id].clear();
+                            }
+                        }
+            }
+
+            /**
+               Returns the ratio of the bytes of the packed messages to the bytes sent since the compression has been
+               enabled, 1 if nothing has been sent.
+            */
+            double compression_ratio() const {
+                return m_compressed_bytes ? double(m_raw_bytes) / m_compressed_bytes : 1;
+            }
+
+            /**
+               Function to select whether the exchanges are driven by the progress thread of the pattern, see
+               Halo_Exchange_3D::use_progress_thread. The data of each neighbor is unpacked by the thread into the
+               fields passed to pack as soon as it arrives, hence unpack only releases the buffers, and
+               pattern().received tells which halos are already up to date.
+
+               \param value true to use a progress thread
+            */
+            void use_progress_thread(bool value) {
+                base_type::m_haloexch.use_progress_thread(value);
+                if (value)
+                    base_type::m_haloexch.on_receive([this](int I, int J, int K) { unpack_neighbor(I, J, K); });
+                else
+                    base_type::m_haloexch.on_receive(nullptr);
+            }
+
+            /**
+               Exchanges the halos of the fields in a pipeline, in place of the sequence of pack, start_exchange,
+               wait and unpack. The message to each neighbor is packed (and compressed) and sent before the next one
+               is packed, and the data of each neighbor is unpacked as soon as it arrives, while the others are in
+               flight, such that packing, transfers and unpacking overlap. The message of a neighbor holds the
+               regions of all the fields, the granularity of the pipeline is hence the neighbor. Not available with
+               the progress thread, which already unpacks the data as it arrives.
+
+               \param[in] fields vector with data fields pointers to be exchanged
+            */
+            void exchange_pipelined(std::vector<DataType *> const &fields) {
+                assert(!pattern().uses_progress_thread());
+                auto &haloexch = base_type::m_haloexch;
+                const int num_fields = fields.size();
+                m_packed_fields.assign(fields.begin(), fields.end());
+                if (m_use_datatypes) {
+                    std::vector<DataType const *> const_fields(fields.begin(), fields.end());
+                    register_datatypes(const_fields.data(), num_fields);
+                } else {
+                    set_message_sizes(num_fields);
+                    if (compresses())
+                        register_compressed_receives(num_fields);
+                }
+                haloexch.start_pipeline();
+                std::size_t raw_bytes = 0, compressed_bytes = 0;
+                for (int n = 0; n < static_pow3(DIMS); ++n) {
+                    const int ii = n / 9 - 1, jj = n / 3 % 3 - 1, kk = n % 3 - 1;
+                    typedef proc_layout map_type;
+                    const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                    const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                    const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                    if ((ii == 0 && jj == 0 && kk == 0) || pattern().proc_grid().proc(ii_P, jj_P, kk_P) == -1)
+                        continue;
+                    if (!m_use_datatypes && num_fields) {
+                        process_planes<true>(fields.data(), num_fields, n);
+                        compress_message(n, num_fields, raw_bytes, compressed_bytes);
+                    }
+                    haloexch.send_to(ii_P, jj_P, kk_P);
+                }
+                m_raw_bytes += raw_bytes;
+                m_compressed_bytes += compressed_bytes;
+                int I, J, K;
+                while (haloexch.wait_any(I, J, K)) {
+                    if (m_use_datatypes || !num_fields)
+                        continue;
+                    for (int n = 0; n < static_pow3(DIMS); ++n) {
+                        const int ii = n / 9 - 1, jj = n / 3 % 3 - 1, kk = n % 3 - 1;
+                        typedef proc_layout map_type;
+                        if (nth<map_type, 0>(ii, jj, kk) != I || nth<map_type, 1>(ii, jj, kk) != J ||
+                            nth<map_type, 2>(ii, jj, kk) != K)
+                            continue;
+                        const int id = translate()(ii, jj, kk);
+                        if (is_compressed(I, J, K) && recv_size[id])
+                            decompress_message(id, num_fields);
+                        process_planes<false>(fields.data(), num_fields, n);
+                    }
+                }
+                pattern().release_shared_send_buffers();
+            }
+
+            /**
+               Exchanges the halos of the fields in a pipeline, see exchange_pipelined above.
+
+               \param[in] _fields data fields to be exchanged
+            */
+            template <typename... FIELDS>
+            void exchange_pipelined(FIELDS *..._fields) {
+                exchange_pipelined(std::vector<DataType *>{_fields...});
+            }
 
             /**
                Function to pack data to be sent
@@ -489,6 +733,278 @@ namespace gridtools {
             friend struct allocation_service<this_type>;
 
           private:
+            // the received data is already in the fields when unpack is called
+            bool unpacked_on_arrival() const { return m_use_datatypes || pattern().uses_progress_thread(); }
+
+            bool compresses() const { return !m_compression.empty(); }
+
+            // whether the messages exchanged with the neighbor (ii_P, jj_P, kk_P) of the process grid are compressed
+            bool is_compressed(int ii_P, int jj_P, int kk_P) const {
+                return compresses() && pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1 &&
+                       !pattern().is_shared_neighbor(ii_P, jj_P, kk_P);
+            }
+
+            halo_compression compression(std::size_t field) const {
+                return field < m_compression.size() ? m_compression[field] : halo_compression();
+            }
+
+            // compresses the packed message to the neighbor in the direction n and registers it with the pattern
+            void compress_message(int n, int num_fields, std::size_t &raw_bytes, std::size_t &compressed_bytes) {
+                const int ii = n / 9 - 1, jj = n / 3 % 3 - 1, kk = n % 3 - 1;
+                const int id = translate()(ii, jj, kk);
+                typedef proc_layout map_type;
+                const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                if ((ii == 0 && jj == 0 && kk == 0) || !is_compressed(ii_P, jj_P, kk_P))
+                    return;
+                unsigned char *out = m_compressed[0][id].data();
+                for (int f = 0; f < num_fields; ++f)
+                    out += compress(compression(f),
+                        send_buffer[id] + f * send_size[id],
+                        send_size[id],
+                        out,
+                        m_scratch[id]);
+                int size = send_size[id] ? out - m_compressed[0][id].data() : 0;
+                raw_bytes += send_size[id] * num_fields * sizeof(DataType);
+                compressed_bytes += size;
+                base_type::m_haloexch.register_send_to_buffer(m_compressed[0][id].data(), size, ii_P, jj_P, kk_P);
+            }
+
+            // compresses the packed messages and registers the compressed send and receive buffers with the pattern
+            void compress_messages(int num_fields) {
+                std::size_t raw_bytes = 0, compressed_bytes = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : raw_bytes, compressed_bytes)
+                for (int n = 0; n < static_pow3(DIMS); ++n)
+                    compress_message(n, num_fields, raw_bytes, compressed_bytes);
+                m_raw_bytes += raw_bytes;
+                m_compressed_bytes += compressed_bytes;
+                register_compressed_receives(num_fields);
+            }
+
+            // registers with the pattern the buffers receiving the compressed messages, of their maximum sizes
+            void register_compressed_receives(int num_fields) {
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            const int id = translate()(ii, jj, kk);
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            if ((ii == 0 && jj == 0 && kk == 0) || !is_compressed(ii_P, jj_P, kk_P))
+                                continue;
+                            base_type::m_haloexch.register_receive_from_buffer(m_compressed[1][id].data(),
+                                recv_size[id] ? num_fields * compressed_bound(recv_size[id] * sizeof(DataType)) : 0,
+                                ii_P,
+                                jj_P,
+                                kk_P);
+                        }
+            }
+
+            // decompresses the message received from the neighbor id into its receive buffer
+            void decompress_message(int id, int num_fields) const {
+                unsigned char const *in = m_compressed[1][id].data();
+                for (int f = 0; f < num_fields; ++f)
+                    in += decompress(in, recv_buffer[id] + f * recv_size[id], recv_size[id], m_scratch[id]);
+            }
+
+            void decompress_messages(int num_fields) const {
+                if (!compresses())
+                    return;
+#pragma omp parallel for schedule(dynamic)
+                for (int n = 0; n < static_pow3(DIMS); ++n) {
+                    const int ii = n / 9 - 1, jj = n / 3 % 3 - 1, kk = n % 3 - 1;
+                    const int id = translate()(ii, jj, kk);
+                    typedef proc_layout map_type;
+                    const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                    const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                    const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                    if ((ii != 0 || jj != 0 || kk != 0) && recv_size[id] && is_compressed(ii_P, jj_P, kk_P))
+                        decompress_message(id, num_fields);
+                }
+            }
+
+            // unpacks the data received from the neighbor (I, J, K) of the process grid into the packed fields
+            void unpack_neighbor(int I, int J, int K) const {
+                if (m_use_datatypes)
+                    return;
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            typedef proc_layout map_type;
+                            if (nth<map_type, 0>(ii, jj, kk) != I || nth<map_type, 1>(ii, jj, kk) != J ||
+                                nth<map_type, 2>(ii, jj, kk) != K)
+                                continue;
+                            const array<int, 3> eta = {ii, jj, kk};
+                            const int id = translate()(ii, jj, kk);
+                            if (is_compressed(I, J, K) && recv_size[id])
+                                decompress_message(id, m_packed_fields.size());
+                            auto const *received =
+                                is_compressed(I, J, K)
+                                    ? recv_buffer[id]
+                                    : reinterpret_cast<DataType const *>(pattern().receive_buffer(I, J, K));
+                            auto const &hk = halo.halos[2];
+                            const int plane_size = halo.halos[0].r_length(ii) * halo.halos[1].r_length(jj);
+                            for (std::size_t f = 0; f != m_packed_fields.size(); ++f)
+                                for (int plane = 0; plane < (int)hk.r_length(kk); ++plane)
+                                    halo.unpack_plane(eta,
+                                        const_cast<DataType *>(m_packed_fields[f]),
+                                        hk.loop_low_bound_outside(kk) + plane,
+                                        received + f * recv_size[id] + plane * plane_size);
+                        }
+            }
+
+            void free_datatypes() {
+                int finalized;
+                MPI_Finalized(&finalized);
+                for (int d = 0; d < 2; ++d) {
+                    for (auto *types : {&m_field_types[d], &m_message_types[d]}) {
+                        for (MPI_Datatype &type : *types)
+                            if (type != MPI_DATATYPE_NULL && !finalized)
+                                MPI_Type_free(&type);
+                        types->clear();
+                    }
+                }
+                m_fields.clear();
+            }
+
+            /*
+              Registers with the pattern the messages made of the halo regions of the fields, in the derived
+              datatypes mode. The datatypes of the previous fields are freed after the new ones are registered, such
+              that the handles differ and the persistent requests made for the previous ones are not reused.
+            */
+            void register_datatypes(DataType const *const *fields, int num_fields) {
+                if (std::equal(fields, fields + num_fields, m_fields.begin(), m_fields.end()))
+                    return;
+                std::vector<MPI_Aint> addresses(num_fields);
+                for (int f = 0; f < num_fields; ++f)
+                    MPI_Get_address(fields[f], &addresses[f]);
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            if (ii == 0 && jj == 0 && kk == 0)
+                                continue;
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            const int id = translate()(ii, jj, kk);
+                            MPI_Datatype previous[2] = {m_message_types[0][id], m_message_types[1][id]};
+                            for (int d = 0; d < 2; ++d) {
+                                MPI_Datatype &type = m_message_types[d][id];
+                                type = MPI_DATATYPE_NULL;
+                                if (m_field_types[d][id] == MPI_DATATYPE_NULL || num_fields == 0)
+                                    continue;
+                                MPI_Type_create_hindexed_block(
+                                    num_fields, 1, addresses.data(), m_field_types[d][id], &type);
+                                MPI_Type_commit(&type);
+                            }
+                            // the regions without a datatype are empty, hence their sizes are 0
+                            base_type::m_haloexch.template register_datatype<true>(m_message_types[0][id],
+                                send_size[id] * num_fields * sizeof(DataType),
+                                ii_P,
+                                jj_P,
+                                kk_P);
+                            base_type::m_haloexch.template register_datatype<false>(m_message_types[1][id],
+                                recv_size[id] * num_fields * sizeof(DataType),
+                                ii_P,
+                                jj_P,
+                                kk_P);
+                            for (MPI_Datatype &type : previous)
+                                if (type != MPI_DATATYPE_NULL)
+                                    MPI_Type_free(&type);
+                        }
+                m_fields.assign(fields, fields + num_fields);
+            }
+
+            /*
+              Packs the fields into the send buffers (Pack == true) or unpacks them from the receive buffers. The units
+              of work distributed among the threads are the k-planes of the regions of each field exchanged with each
+              neighbor, such that the faces, which are much larger than the edges and the corners, are split among
+              the threads. Within a plane, the contiguous rows are block copied. The data of the neighbors served
+              through the shared memory window is unpacked directly from their send buffers. A direction n, with
+              eta = {n / 9 - 1, n / 3 % 3 - 1, n % 3 - 1}, restricts the work to the region of that neighbor.
+            */
+            template <bool Pack, typename Ptr>
+            void process_planes(Ptr const *fields, int num_fields, int direction = -1) const {
+                array<bool, static_pow3(DIMS)> has_neighbor;
+                array<DataType const *, static_pow3(DIMS)> received;
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            has_neighbor[translate()(ii, jj, kk)] =
+                                (ii != 0 || jj != 0 || kk != 0) && pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1;
+                            // the compressed messages are decompressed into the receive buffers
+                            if (!Pack && has_neighbor[translate()(ii, jj, kk)])
+                                received[translate()(ii, jj, kk)] =
+                                    is_compressed(ii_P, jj_P, kk_P)
+                                        ? recv_buffer[translate()(ii, jj, kk)]
+                                        : reinterpret_cast<DataType const *>(
+                                              pattern().receive_buffer(ii_P, jj_P, kk_P));
+                        }
+
+                auto const &hk = halo.halos[2];
+                const int max_planes = std::max({hk.r_length(-1), hk.r_length(0), hk.r_length(1)});
+                const int first = direction < 0 ? 0 : direction;
+                const int num_tasks = (direction < 0 ? static_pow3(DIMS) : 1) * num_fields * max_planes;
+#pragma omp parallel for schedule(dynamic)
+                for (int t = 0; t < num_tasks; ++t) {
+                    const int plane = t % max_planes;
+                    const int f = t / max_planes % num_fields;
+                    const int n = first + t / max_planes / num_fields;
+                    const array<int, 3> eta = {n / 9 - 1, n / 3 % 3 - 1, n % 3 - 1};
+                    const int id = translate()(eta[0], eta[1], eta[2]);
+                    if (!has_neighbor[id])
+                        continue;
+                    if constexpr (Pack) {
+                        if (plane >= (int)hk.s_length(eta[2]))
+                            continue;
+                        int plane_size = halo.halos[0].s_length(eta[0]) * halo.halos[1].s_length(eta[1]);
+                        halo.pack_plane(eta,
+                            fields[f],
+                            hk.loop_low_bound_inside(eta[2]) + plane,
+                            send_buffer[id] + f * send_size[id] + plane * plane_size);
+                    } else {
+                        if (plane >= (int)hk.r_length(eta[2]))
+                            continue;
+                        int plane_size = halo.halos[0].r_length(eta[0]) * halo.halos[1].r_length(eta[1]);
+                        halo.unpack_plane(eta,
+                            fields[f],
+                            hk.loop_low_bound_outside(eta[2]) + plane,
+                            received[id] + f * recv_size[id] + plane * plane_size);
+                    }
+                }
+            }
+
+            void set_message_sizes(int num_fields) {
+                for (int ii = -1; ii <= 1; ++ii)
+                    for (int jj = -1; jj <= 1; ++jj)
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            if ((ii != 0 || jj != 0 || kk != 0) &&
+                                (pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
+                                base_type::m_haloexch.set_send_to_size(
+                                    send_size[translate()(ii, jj, kk)] * num_fields * sizeof(DataType),
+                                    ii_P,
+                                    jj_P,
+                                    kk_P);
+                                base_type::m_haloexch.set_receive_from_size(
+                                    recv_size[translate()(ii, jj, kk)] * num_fields * sizeof(DataType),
+                                    ii_P,
+                                    jj_P,
+                                    kk_P);
+                            }
+                        }
+            }
+
             template <int I, int dummy>
             struct pack_dims {};
 
@@ -496,33 +1012,16 @@ namespace gridtools {
             struct pack_dims<3, dummy> {
                 template <typename T, typename... FIELDS>
                 void operator()(T &hm, const FIELDS &..._fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                    hm.halo.pack_all({ii, jj, kk}, it, _fields...);
-
-                                    hm.m_haloexch.set_send_to_size(
-                                        hm.send_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                    hm.m_haloexch.set_receive_from_size(
-                                        hm.recv_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                }
-                            }
-                        }
+                    std::array<DataType const *, sizeof...(_fields)> fields = {_fields...};
+                    hm.m_packed_fields.assign(fields.begin(), fields.end());
+                    if (hm.m_use_datatypes) {
+                        hm.register_datatypes(fields.data(), sizeof...(_fields));
+                        return;
                     }
+                    hm.template process_planes<true>(fields.data(), sizeof...(_fields));
+                    hm.set_message_sizes(sizeof...(_fields));
+                    if (hm.compresses())
+                        hm.compress_messages(sizeof...(_fields));
                 }
             };
 
@@ -533,22 +1032,12 @@ namespace gridtools {
             struct unpack_dims<3, dummy> {
                 template <typename T, typename... FIELDS>
                 void operator()(const T &hm, const FIELDS &..._fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                    hm.halo.unpack_all({ii, jj, kk}, it, _fields...);
-                                }
-                            }
-                        }
+                    std::array<DataType *, sizeof...(_fields)> fields = {_fields...};
+                    if (!hm.unpacked_on_arrival()) {
+                        hm.decompress_messages(sizeof...(_fields));
+                        hm.template process_planes<false>(fields.data(), sizeof...(_fields));
                     }
+                    hm.pattern().release_shared_send_buffers();
                 }
             };
 
@@ -559,35 +1048,18 @@ namespace gridtools {
             struct pack_vector_dims<3, dummy> {
                 template <typename T>
                 void operator()(T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                    for (size_t i = 0; i < fields.size(); ++i) {
-                                        hm.halo.pack({ii, jj, kk}, fields[i], it);
-                                    }
-
-                                    hm.m_haloexch.set_send_to_size(
-                                        hm.send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                    hm.m_haloexch.set_receive_from_size(
-                                        hm.recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                }
-                            }
-                        }
+                    hm.m_packed_fields.assign(fields.begin(), fields.end());
+                    if (hm.m_use_datatypes) {
+                        std::vector<DataType const *> const_fields(fields.begin(), fields.end());
+                        hm.register_datatypes(const_fields.data(), fields.size());
+                        return;
                     }
+                    if (fields.empty())
+                        return;
+                    hm.template process_planes<true>(fields.data(), fields.size());
+                    hm.set_message_sizes(fields.size());
+                    if (hm.compresses())
+                        hm.compress_messages(fields.size());
                 }
             };
 
@@ -598,24 +1070,11 @@ namespace gridtools {
             struct unpack_vector_dims<3, dummy> {
                 template <typename T>
                 void operator()(const T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                    for (size_t i = 0; i < fields.size(); ++i) {
-                                        hm.halo.unpack({ii, jj, kk}, fields[i], it);
-                                    }
-                                }
-                            }
-                        }
+                    if (!fields.empty() && !hm.unpacked_on_arrival()) {
+                        hm.decompress_messages(fields.size());
+                        hm.template process_planes<false>(fields.data(), fields.size());
                     }
+                    hm.pattern().release_shared_send_buffers();
                 }
             };
 
@@ -629,7 +1088,9 @@ namespace gridtools {
                     for (int i = -1; i <= 1; ++i) {
                         for (int j = -1; j <= 1; ++j) {
                             for (int k = -1; k <= 1; ++k) {
-                                gcl_alloc<DataType, arch_type>::free(hm->send_buffer[translate()(i, j, k)]);
+                                // the send buffers in shared memory are owned by the pattern
+                                if (!hm->m_haloexch.has_shared_send_buffers())
+                                    gcl_alloc<DataType, arch_type>::free(hm->send_buffer[translate()(i, j, k)]);
                                 gcl_alloc<DataType, arch_type>::free(hm->recv_buffer[translate()(i, j, k)]);
                             }
                         }
@@ -9,6 +9,9 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+
 #include "../../common/array.hpp"
 #include "../../common/defs.hpp"
 #include "../low_level/arch.hpp"
@@ -104,22 +107,41 @@ namespace gridtools {
                 typedef translate_t<3> translate;
                 typedef translate_t<3, procmap> translate_P;
 
+                // with the shared memory transport, the send buffers are allocated by the pattern
+                const bool shared = std::is_same_v<arch, cpu> && hm->m_haloexch.uses_shared_memory();
+                if (shared) {
+                    std::size_t sizes[27] = {};
+                    for (int ii = -1; ii <= 1; ++ii)
+                        for (int jj = -1; jj <= 1; ++jj)
+                            for (int kk = -1; kk <= 1; ++kk) {
+                                typedef typename translate_P::map_type map_type;
+                                sizes[translate()(nth<map_type, 0>(ii, jj, kk),
+                                    nth<map_type, 1>(ii, jj, kk),
+                                    nth<map_type, 2>(ii, jj, kk))] =
+                                    hm->halo.send_buffer_size({ii, jj, kk}) * sizeof(Datatype) * mf;
+                            }
+                    hm->m_haloexch.allocate_shared_send_buffers(sizes);
+                }
+
                 for (int ii = -1; ii <= 1; ++ii)
                     for (int jj = -1; jj <= 1; ++jj)
                         for (int kk = -1; kk <= 1; ++kk)
                             if (ii != 0 || jj != 0 || kk != 0) {
                                 hm->send_size[translate()(ii, jj, kk)] = hm->halo.send_buffer_size({ii, jj, kk});
                                 hm->recv_size[translate()(ii, jj, kk)] = hm->halo.recv_buffer_size({ii, jj, kk});
-                                hm->send_buffer[translate()(ii, jj, kk)] =
-                                    gcl_alloc<Datatype, arch>::alloc(hm->halo.send_buffer_size({ii, jj, kk}) * mf);
-                                hm->recv_buffer[translate()(ii, jj, kk)] =
-                                    gcl_alloc<Datatype, arch>::alloc(hm->halo.recv_buffer_size({ii, jj, kk}) * mf);
-
                                 typedef typename translate_P::map_type map_type;
                                 const int ii_P = nth<map_type, 0>(ii, jj, kk);
                                 const int jj_P = nth<map_type, 1>(ii, jj, kk);
                                 const int kk_P = nth<map_type, 2>(ii, jj, kk);
 
+                                hm->send_buffer[translate()(ii, jj, kk)] =
+                                    shared ? reinterpret_cast<Datatype *>(
+                                                 hm->m_haloexch.shared_send_buffer(ii_P, jj_P, kk_P))
+                                           : gcl_alloc<Datatype, arch>::alloc(
+                                                 hm->halo.send_buffer_size({ii, jj, kk}) * mf);
+                                hm->recv_buffer[translate()(ii, jj, kk)] =
+                                    gcl_alloc<Datatype, arch>::alloc(hm->halo.recv_buffer_size({ii, jj, kk}) * mf);
+
                                 hm->m_haloexch.register_send_to_buffer(&(hm->send_buffer[translate()(ii, jj, kk)][0]),
                                     hm->halo.send_buffer_size({ii, jj, kk}) * sizeof(Datatype) * mf,
                                     ii_P,
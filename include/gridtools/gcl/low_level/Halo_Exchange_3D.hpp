@@ -9,6 +9,18 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
 #include "../../common/defs.hpp"
 #include "../GCL.hpp"
 #include "translate.hpp"
@@ -209,13 +221,17 @@ namespace gridtools {
                 }
 
                 char *&buffer(int I, int J, int K) { return m_buffers[translate()(I, J, K)]; }
+                char *buffer(int I, int J, int K) const { return m_buffers[translate()(I, J, K)]; }
                 int &size(int I, int J, int K) { return m_size[translate()(I, J, K)]; }
                 int size(int I, int J, int K) const { return m_size[translate()(I, J, K)]; }
             };
 
+            // the tag of the messages sent towards the neighbor (I, J, K)
+            static constexpr int tag(int I, int J, int K) { return (K + 1) * 9 + (I + 1) * 3 + J + 1; }
+
             template <int I, int J, int K>
             struct TAG {
-                static const int value = (K + 1) * 9 + (I + 1) * 3 + J + 1;
+                static const int value = tag(I, J, K);
             };
 
             struct request_t {
@@ -240,17 +256,483 @@ namespace gridtools {
             sr_buffers m_send_buffers;
             sr_buffers m_recv_buffers;
 
+            /*
+              Derived datatypes of the messages, MPI_DATATYPE_NULL for the neighbors exchanging the bytes of their
+              buffers. A message with a datatype is a single element of it addressed from MPI_BOTTOM, hence the data
+              is sent from and received into the memory the datatype describes, without staging copies. The datatypes
+              are owned by the caller.
+            */
+            MPI_Datatype m_send_types[27];
+            MPI_Datatype m_recv_types[27];
+
+            // the buffer, the count and the datatype of the message to (Send == true) or from the neighbor (i, j, k)
+            template <bool Send>
+            std::tuple<void *, int, MPI_Datatype> message(int i, int j, int k) const {
+                MPI_Datatype type = (Send ? m_send_types : m_recv_types)[translate()(i, j, k)];
+                if (type != MPI_DATATYPE_NULL)
+                    return {MPI_BOTTOM, 1, type};
+                sr_buffers const &buffers = Send ? m_send_buffers : m_recv_buffers;
+                return {buffers.buffer(i, j, k), buffers.size(i, j, k), MPI_CHAR};
+            }
+
             request_t request;
             request_t_mark send_request;
 
+            /*
+              Persistent requests, one per neighbor and direction. A request is (re)created when the buffer or the
+              size registered for its neighbor changes, hence it is set up once for a fixed communication pattern.
+              Copies of the pattern do not share the requests.
+            */
+            struct persistent_requests {
+                MPI_Request m_request[2][27];
+                char *m_buffer[2][27];
+                int m_size[2][27];
+                MPI_Datatype m_type[2][27];
+                std::vector<MPI_Request> m_active; // the requests started and not yet completed
+                std::vector<int> m_source;         // the neighbor of each active receive, -1 for the sends
+
+                persistent_requests() {
+                    for (int d = 0; d < 2; ++d)
+                        for (int i = 0; i < 27; ++i) {
+                            m_request[d][i] = MPI_REQUEST_NULL;
+                            m_buffer[d][i] = nullptr;
+                            m_size[d][i] = 0;
+                            m_type[d][i] = MPI_DATATYPE_NULL;
+                        }
+                }
+                persistent_requests(persistent_requests const &) : persistent_requests() {}
+                persistent_requests &operator=(persistent_requests const &) {
+                    free();
+                    return *this;
+                }
+                ~persistent_requests() { free(); }
+
+                void free() {
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    for (int d = 0; d < 2; ++d)
+                        for (int i = 0; i < 27; ++i) {
+                            if (m_request[d][i] != MPI_REQUEST_NULL && !finalized)
+                                MPI_Request_free(&m_request[d][i]);
+                            m_request[d][i] = MPI_REQUEST_NULL;
+                            m_buffer[d][i] = nullptr;
+                            m_size[d][i] = 0;
+                            m_type[d][i] = MPI_DATATYPE_NULL;
+                        }
+                    m_active.clear();
+                    m_source.clear();
+                }
+            };
+
             const PROC_GRID /*&*/ m_proc_grid;
 
+            bool m_use_persistent_requests = false;
+            persistent_requests m_persistent;
+
+            /*
+              Intra-node transport. The send buffers are allocated in an MPI-3 shared memory window of the processes
+              of the node, and the data coming from node-local neighbors is unpacked directly from their send buffers,
+              without going through MPI messages or receive buffers. The send buffers are ready to be read after a
+              fence following the packing, and can be packed again after a second fence following the unpacking.
+            */
+            struct shared_memory {
+                MPI_Comm m_comm = MPI_COMM_NULL; // the processes of the node
+                MPI_Win m_win = MPI_WIN_NULL;
+                int m_peer[27];          // rank in m_comm of the neighbor, -1 if it is not on the node
+                char *m_buffer[27];      // the own send buffers
+                char *m_peer_buffer[27]; // the send buffers of the neighbors directed to this process
+
+                shared_memory() { reset(); }
+                shared_memory(shared_memory const &) : shared_memory() {}
+                shared_memory &operator=(shared_memory const &) {
+                    free();
+                    return *this;
+                }
+                ~shared_memory() { free(); }
+
+                void reset() {
+                    for (int i = 0; i < 27; ++i) {
+                        m_peer[i] = -1;
+                        m_buffer[i] = nullptr;
+                        m_peer_buffer[i] = nullptr;
+                    }
+                }
+
+                void free_window() {
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    if (m_win != MPI_WIN_NULL && !finalized)
+                        MPI_Win_free(&m_win);
+                    m_win = MPI_WIN_NULL;
+                    for (int i = 0; i < 27; ++i) {
+                        m_buffer[i] = nullptr;
+                        m_peer_buffer[i] = nullptr;
+                    }
+                }
+
+                void free() {
+                    free_window();
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    if (m_comm != MPI_COMM_NULL && !finalized)
+                        MPI_Comm_free(&m_comm);
+                    m_comm = MPI_COMM_NULL;
+                    reset();
+                }
+
+                // the neighbor is served through the shared memory window
+                bool is_local(int id) const { return m_win != MPI_WIN_NULL && m_peer[id] != -1; }
+            };
+
+            shared_memory m_shared;
+
+            /*
+              Neighborhood collective transport. The messages of an exchange go through a single
+              MPI_Ineighbor_alltoallw on a distributed graph communicator with an edge per neighbor, made once. The
+              buffers are addressed by their absolute addresses (relative to MPI_BOTTOM), hence they need not be
+              contiguous. A process may be the neighbor in several directions (periodic grids with few processes); the
+              multiple edges between two processes are matched in the order in which they are listed, hence the
+              sources are listed in the order of the directions of the destinations on the other end. The neighbors
+              served through the shared memory window get empty messages.
+            */
+            struct neighborhood_collective {
+                struct direction {
+                    int i, j, k;
+                };
+                MPI_Comm m_comm = MPI_COMM_NULL;
+                std::vector<direction> m_directions[2]; // of the sources (0) and of the destinations (1)
+                std::vector<int> m_counts[2];
+                std::vector<MPI_Aint> m_displacements[2];
+                std::vector<MPI_Datatype> m_types[2];
+                MPI_Request m_request = MPI_REQUEST_NULL;
+
+                neighborhood_collective() = default;
+                neighborhood_collective(neighborhood_collective const &) : neighborhood_collective() {}
+                neighborhood_collective &operator=(neighborhood_collective const &) {
+                    free();
+                    return *this;
+                }
+                ~neighborhood_collective() { free(); }
+
+                void free() {
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    if (m_comm != MPI_COMM_NULL && !finalized)
+                        MPI_Comm_free(&m_comm);
+                    m_comm = MPI_COMM_NULL;
+                    for (int d = 0; d < 2; ++d) {
+                        m_directions[d].clear();
+                        m_counts[d].clear();
+                        m_displacements[d].clear();
+                        m_types[d].clear();
+                    }
+                }
+            };
+
+            neighborhood_collective m_collective;
+
+            /*
+              Progress thread. When enabled, the exchange started by Halo_Exchange_3D::do_sends is driven by a
+              thread which calls MPI_Testsome on its requests until they complete, and reports each neighbor whose
+              data has arrived, by a flag and by the callback, as soon as it happens. The data of the neighbors served
+              through the shared memory window is reported at the start. Halo_Exchange_3D::wait joins the thread.
+              Copies of the pattern do not share the thread.
+            */
+            struct progress_thread {
+                bool m_enabled = false;
+                std::thread m_thread;
+                std::function<void(int, int, int)> m_callback;
+                std::atomic<bool> m_received[27];
+                std::vector<MPI_Request> m_requests; // the requests of the exchange in progress
+                std::vector<int> m_source;           // the neighbor of each request, as in persistent_requests
+
+                progress_thread() {
+                    for (auto &received : m_received)
+                        received = false;
+                }
+                progress_thread(progress_thread const &other) : progress_thread() {
+                    m_enabled = other.m_enabled;
+                    m_callback = other.m_callback;
+                }
+                progress_thread &operator=(progress_thread const &other) {
+                    join();
+                    m_enabled = other.m_enabled;
+                    m_callback = other.m_callback;
+                    return *this;
+                }
+                ~progress_thread() { join(); }
+
+                void join() {
+                    if (m_thread.joinable())
+                        m_thread.join();
+                }
+            };
+
+            progress_thread m_progress;
+
+            // the source of a request completing the messages from all the neighbors
+            static constexpr int all_sources = -2;
+
+            // reports the data of the neighbor id, or of all the neighbors, as received
+            void notify_received(int source) {
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            int id = translate()(i, j, k);
+                            if (source != all_sources ? id != source : !has_message<false>(i, j, k))
+                                continue;
+                            m_progress.m_received[id].store(true, std::memory_order_release);
+                            if (m_progress.m_callback)
+                                m_progress.m_callback(i, j, k);
+                        }
+            }
+
+            // collects the requests of the exchange which is starting and launches the progress thread on them
+            void start_progress_thread() {
+                if (!m_progress.m_enabled)
+                    return;
+                for (auto &received : m_progress.m_received)
+                    received = false;
+                auto &requests = m_progress.m_requests;
+                auto &source = m_progress.m_source;
+                requests.clear();
+                source.clear();
+                if (uses_neighborhood_collectives()) {
+                    requests.push_back(m_collective.m_request);
+                    source.push_back(all_sources);
+                } else if (m_use_persistent_requests) {
+                    // the handles of persistent requests are not modified by the completion
+                    requests = m_persistent.m_active;
+                    source = m_persistent.m_source;
+                    m_persistent.m_active.clear();
+                    m_persistent.m_source.clear();
+                } else {
+                    for (int k = -1; k <= 1; ++k)
+                        for (int j = -1; j <= 1; ++j)
+                            for (int i = -1; i <= 1; ++i) {
+                                if (has_message<false>(i, j, k)) {
+                                    requests.push_back(request(-i, -j, -k));
+                                    source.push_back(translate()(i, j, k));
+                                }
+                                if (send_request.marked(i, j, k)) {
+                                    requests.push_back(send_request(i, j, k));
+                                    source.push_back(-1);
+                                    send_request.reset(i, j, k);
+                                }
+                            }
+                }
+                m_progress.m_thread = std::thread([this] {
+                    for (int k = -1; k <= 1; ++k)
+                        for (int j = -1; j <= 1; ++j)
+                            for (int i = -1; i <= 1; ++i) {
+                                int id = translate()(i, j, k);
+                                if (m_proc_grid.proc(i, j, k) != -1 && m_recv_buffers.size(i, j, k) &&
+                                    m_shared.is_local(id))
+                                    notify_received(id);
+                            }
+                    auto &requests = m_progress.m_requests;
+                    std::vector<int> indices(requests.size());
+                    for (std::size_t remaining = requests.size(); remaining;) {
+                        int count;
+                        MPI_Testsome(requests.size(), requests.data(), &count, indices.data(), MPI_STATUSES_IGNORE);
+                        if (count == MPI_UNDEFINED)
+                            break;
+                        if (!count)
+                            std::this_thread::yield();
+                        for (int n = 0; n < count; ++n) {
+                            --remaining;
+                            if (m_progress.m_source[indices[n]] != -1)
+                                notify_received(m_progress.m_source[indices[n]]);
+                        }
+                    }
+                });
+            }
+
+            /*
+              State of a pipelined exchange, in which the message to each neighbor is sent as soon as its buffer is
+              filled and the messages from the neighbors are completed one at a time, see
+              Halo_Exchange_3D::start_pipeline. Copies of the pattern do not share the state.
+            */
+            struct pipeline {
+                std::vector<MPI_Request> m_requests; // the requests started and not yet completed
+                std::vector<int> m_source;           // the neighbor of each request, as in persistent_requests
+                std::vector<int> m_local;            // the neighbors served through the shared memory, not reported
+                int m_receives = 0;                  // the receives not yet completed
+                bool m_sending = false;              // whether the messages are being sent
+
+                pipeline() = default;
+                pipeline(pipeline const &) {}
+                pipeline &operator=(pipeline const &) { return *this; }
+            };
+
+            pipeline m_pipeline;
+
+            // the relative coordinates (i, j, k) of the neighbor id, the inverse of translate
+            static void neighbor(int id, int &i, int &j, int &k) {
+                i = id % 3 - 1;
+                j = id / 3 % 3 - 1;
+                k = id / 9 - 1;
+            }
+
+            // starts the exchange of all the messages with the neighborhood collective
+            void start_collective() {
+                auto &c = m_collective;
+                for (int send = 0; send < 2; ++send) {
+                    sr_buffers const &buffers = send ? m_send_buffers : m_recv_buffers;
+                    for (std::size_t n = 0; n != c.m_directions[send].size(); ++n) {
+                        auto dir = c.m_directions[send][n];
+                        bool local = m_shared.is_local(translate()(dir.i, dir.j, dir.k));
+                        auto [data, count, type] =
+                            send ? message<true>(dir.i, dir.j, dir.k) : message<false>(dir.i, dir.j, dir.k);
+                        bool empty = local || !buffers.size(dir.i, dir.j, dir.k);
+                        c.m_counts[send][n] = empty ? 0 : count;
+                        c.m_types[send][n] = type;
+                        c.m_displacements[send][n] = 0;
+                        if (!empty && data != MPI_BOTTOM)
+                            MPI_Get_address(data, &c.m_displacements[send][n]);
+                    }
+                }
+                MPI_Ineighbor_alltoallw(MPI_BOTTOM,
+                    c.m_counts[1].data(),
+                    c.m_displacements[1].data(),
+                    c.m_types[1].data(),
+                    MPI_BOTTOM,
+                    c.m_counts[0].data(),
+                    c.m_displacements[0].data(),
+                    c.m_types[0].data(),
+                    c.m_comm,
+                    &c.m_request);
+            }
+
+          public:
+            /** Statistics of the messages exchanged with a neighbor, accumulated since the construction of the pattern
+                or the last call to Halo_Exchange_3D::reset_statistics. The messages served through the shared memory
+                window are counted as well.
+            */
+            struct neighbor_statistics {
+                std::size_t sent_messages = 0;
+                std::size_t sent_bytes = 0;
+                std::size_t received_messages = 0;
+                std::size_t received_bytes = 0;
+                // [s] time from the beginning of Halo_Exchange_3D::wait to the completion of the receive
+                double wait_time = 0;
+            };
+
+          private:
+            neighbor_statistics m_statistics[27];
+            double m_wait_time = 0;  // [s] total time spent in Halo_Exchange_3D::wait
+            double m_wait_start = 0; // MPI_Wtime at the beginning of the current wait
+
+            // counts the message to (Send == true) or from the neighbor (i, j, k) of an exchange which is starting
+            template <bool Send>
+            void count_message(int i, int j, int k) {
+                int size = (Send ? m_send_buffers : m_recv_buffers).size(i, j, k);
+                if ((i == 0 && j == 0 && k == 0) || m_proc_grid.proc(i, j, k) == -1 || !size)
+                    return;
+                neighbor_statistics &stats = m_statistics[translate()(i, j, k)];
+                if (Send) {
+                    ++stats.sent_messages;
+                    stats.sent_bytes += size;
+                } else {
+                    ++stats.received_messages;
+                    stats.received_bytes += size;
+                }
+            }
+
+            // counts the messages to (Send == true) or from the neighbors of an exchange which is starting
+            template <bool Send>
+            void count_messages() {
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i)
+                            count_message<Send>(i, j, k);
+            }
+
+            // whether the neighbor (i, j, k) is served by an MPI message from (Send == true) or to the buffers
+            template <bool Send>
+            bool has_message(int i, int j, int k) const {
+                sr_buffers const &buffers = Send ? m_send_buffers : m_recv_buffers;
+                return (i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 && buffers.size(i, j, k) &&
+                       !m_shared.is_local(translate()(i, j, k));
+            }
+
+            /*
+              Makes the persistent request for the neighbor (i, j, k) with the registered buffer and size, unless the
+              existing one can be reused. A receive request can be reused for messages shorter than the one it was
+              made for, a send request only for messages of the same size. A request of a derived datatype is reused
+              only for the same datatype.
+            */
+            template <bool Send>
+            MPI_Request &persistent_request(int i, int j, int k) {
+                sr_buffers &buffers = Send ? m_send_buffers : m_recv_buffers;
+                int id = translate()(i, j, k);
+                char *buffer = buffers.buffer(i, j, k);
+                int size = buffers.size(i, j, k);
+                auto [data, count, type] = message<Send>(i, j, k);
+                MPI_Request &request = m_persistent.m_request[Send][id];
+                int capacity = m_persistent.m_size[Send][id];
+                if (request != MPI_REQUEST_NULL && m_persistent.m_buffer[Send][id] == buffer &&
+                    m_persistent.m_type[Send][id] == type && (Send ? size == capacity : size <= capacity))
+                    return request;
+                if (request != MPI_REQUEST_NULL)
+                    MPI_Request_free(&request);
+                if (Send)
+                    MPI_Send_init(data,
+                        count,
+                        type,
+                        m_proc_grid.proc(i, j, k),
+                        tag(i, j, k),
+                        m_proc_grid.communicator(),
+                        &request);
+                else
+                    MPI_Recv_init(data,
+                        count,
+                        type,
+                        m_proc_grid.proc(i, j, k),
+                        tag(-i, -j, -k),
+                        m_proc_grid.communicator(),
+                        &request);
+                m_persistent.m_buffer[Send][id] = buffer;
+                m_persistent.m_size[Send][id] = size;
+                m_persistent.m_type[Send][id] = type;
+                return request;
+            }
+
+            // makes the persistent requests for all the registered buffers
+            void make_persistent_requests() {
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            if (has_message<true>(i, j, k))
+                                persistent_request<true>(i, j, k);
+                            if (has_message<false>(i, j, k))
+                                persistent_request<false>(i, j, k);
+                        }
+            }
+
+            // starts the persistent receives (Send == false) or sends (Send == true) for all the neighbors
+            template <bool Send>
+            void start_persistent() {
+                size_t first = m_persistent.m_active.size();
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i)
+                            if (has_message<Send>(i, j, k)) {
+                                m_persistent.m_active.push_back(persistent_request<Send>(i, j, k));
+                                m_persistent.m_source.push_back(Send ? -1 : translate()(i, j, k));
+                            }
+                // the handles of persistent requests are not modified by the completion, copies can be used
+                if (m_persistent.m_active.size() > first)
+                    MPI_Startall(m_persistent.m_active.size() - first, &m_persistent.m_active[first]);
+            }
+
             template <int I, int J, int K>
             void post_receive() {
-                if (m_recv_buffers.size(I, J, K)) {
-                    MPI_Irecv(static_cast<char *>(m_recv_buffers.buffer(I, J, K)),
-                        m_recv_buffers.size(I, J, K),
-                        MPI_CHAR,
+                if (m_recv_buffers.size(I, J, K) && !m_shared.is_local(translate()(I, J, K))) {
+                    auto [data, count, type] = message<false>(I, J, K);
+                    MPI_Irecv(data,
+                        count,
+                        type,
                         m_proc_grid.template proc<I, J, K>(),
                         TAG<-I, -J, -K>::value,
                         m_proc_grid.communicator(),
@@ -260,10 +742,11 @@ namespace gridtools {
 
             template <int I, int J, int K>
             void perform_isend() {
-                if (m_send_buffers.size(I, J, K)) {
-                    MPI_Isend(static_cast<char *>(m_send_buffers.buffer(I, J, K)),
-                        m_send_buffers.size(I, J, K),
-                        MPI_CHAR,
+                if (m_send_buffers.size(I, J, K) && !m_shared.is_local(translate()(I, J, K))) {
+                    auto [data, count, type] = message<true>(I, J, K);
+                    MPI_Isend(data,
+                        count,
+                        type,
                         m_proc_grid.template proc<I, J, K>(),
                         TAG<I, J, K>::value,
                         m_proc_grid.communicator(),
@@ -286,9 +769,10 @@ namespace gridtools {
 
             template <int I, int J, int K>
             void wait() {
-                if (m_recv_buffers.size(I, J, K)) {
+                if (m_recv_buffers.size(I, J, K) && !m_shared.is_local(translate()(I, J, K))) {
                     MPI_Status status;
                     MPI_Wait(&request(-I, -J, -K), &status);
+                    m_statistics[translate()(I, J, K)].wait_time += MPI_Wtime() - m_wait_start;
                 }
             }
 
@@ -306,7 +790,178 @@ namespace gridtools {
              *
              */
             explicit Halo_Exchange_3D(PROC_GRID /*const&*/ _pg)
-                : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_proc_grid(_pg) {}
+                : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_proc_grid(_pg) {
+                std::fill_n(m_send_types, 27, MPI_DATATYPE_NULL);
+                std::fill_n(m_recv_types, 27, MPI_DATATYPE_NULL);
+            }
+
+            /** Selects whether the communication uses persistent MPI requests (MPI_Send_init/MPI_Recv_init, fired
+                with MPI_Startall and completed with MPI_Waitany). Enabling them sets up the requests for the buffers
+                registered so far, with their registered sizes. An exchange reuses them as long as its buffers do not
+                change and its messages are not longer (receives) or of the same size (sends), and recreates the other
+                ones. Hence a fixed communication pattern pays the message setup overhead once. Must not be called
+                while an exchange is in progress.
+
+                \param[in] value true to use persistent requests
+            */
+            void use_persistent_requests(bool value) {
+                if (value)
+                    make_persistent_requests();
+                else
+                    m_persistent.free();
+                m_use_persistent_requests = value;
+            }
+
+            bool uses_persistent_requests() const { return m_use_persistent_requests; }
+
+            /** Selects whether the messages of an exchange go through a single MPI_Ineighbor_alltoallw on a
+                distributed graph communicator of the neighbors, made here, instead of a pair of point-to-point messages
+                per neighbor. The MPI implementation can then optimize the pattern as a whole, and the progress of the
+                exchange is driven by a single request. It takes precedence over the persistent requests, and the time
+                waited for each neighbor is not measured. Must be called by all the processes of the grid, not while an
+                exchange is in progress.
+
+                \param[in] value true to use the neighborhood collective
+            */
+            void use_neighborhood_collectives(bool value) {
+                m_collective.free();
+                if (!value)
+                    return;
+                std::vector<int> ranks[2];
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            if (i == 0 && j == 0 && k == 0)
+                                continue;
+                            // the neighbor (-i, -j, -k) lists this process as its destination (i, j, k)
+                            if (m_proc_grid.proc(-i, -j, -k) != -1) {
+                                m_collective.m_directions[0].push_back({-i, -j, -k});
+                                ranks[0].push_back(m_proc_grid.proc(-i, -j, -k));
+                            }
+                            if (m_proc_grid.proc(i, j, k) != -1) {
+                                m_collective.m_directions[1].push_back({i, j, k});
+                                ranks[1].push_back(m_proc_grid.proc(i, j, k));
+                            }
+                        }
+                for (int d = 0; d < 2; ++d) {
+                    m_collective.m_counts[d].resize(ranks[d].size());
+                    m_collective.m_displacements[d].resize(ranks[d].size());
+                    m_collective.m_types[d].assign(ranks[d].size(), MPI_BYTE);
+                }
+                MPI_Dist_graph_create_adjacent(m_proc_grid.communicator(),
+                    ranks[0].size(),
+                    ranks[0].data(),
+                    MPI_UNWEIGHTED,
+                    ranks[1].size(),
+                    ranks[1].data(),
+                    MPI_UNWEIGHTED,
+                    MPI_INFO_NULL,
+                    false,
+                    &m_collective.m_comm);
+            }
+
+            bool uses_neighborhood_collectives() const { return m_collective.m_comm != MPI_COMM_NULL; }
+
+            /** Enables the intra-node transport through MPI-3 shared memory for the neighbors running on the same
+                node. Must be called by all the processes of the grid, before allocating the send buffers with
+                Halo_Exchange_3D::allocate_shared_send_buffers. The neighbors which are not on the node, and all of
+                them if the send buffers are registered with Halo_Exchange_3D::register_send_to_buffer, are served
+                through MPI messages.
+
+                \param[in] value true to enable the shared memory transport
+            */
+            void use_shared_memory(bool value) {
+                m_shared.free();
+                if (!value)
+                    return;
+                MPI_Comm_split_type(
+                    m_proc_grid.communicator(), MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &m_shared.m_comm);
+                MPI_Group grid_group, node_group;
+                MPI_Comm_group(m_proc_grid.communicator(), &grid_group);
+                MPI_Comm_group(m_shared.m_comm, &node_group);
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            int proc = m_proc_grid.proc(i, j, k);
+                            if ((i == 0 && j == 0 && k == 0) || proc == -1)
+                                continue;
+                            int peer;
+                            MPI_Group_translate_ranks(grid_group, 1, &proc, node_group, &peer);
+                            m_shared.m_peer[translate()(i, j, k)] = peer == MPI_UNDEFINED ? -1 : peer;
+                        }
+                MPI_Group_free(&grid_group);
+                MPI_Group_free(&node_group);
+            }
+
+            bool uses_shared_memory() const { return m_shared.m_comm != MPI_COMM_NULL; }
+
+            bool has_shared_send_buffers() const { return m_shared.m_win != MPI_WIN_NULL; }
+
+            // whether the neighbor (I, J, K) is served through the shared memory window instead of MPI messages
+            bool is_shared_neighbor(int I, int J, int K) const { return m_shared.is_local(translate()(I, J, K)); }
+
+            /** Allocates the send buffers in the shared memory window of the node. Must be called by all the
+                processes of the grid after Halo_Exchange_3D::use_shared_memory. The buffers are retrieved with
+                Halo_Exchange_3D::shared_send_buffer and released with the pattern.
+
+                \param[in] sizes Sizes in bytes of the send buffers, indexed as the neighbors by translate_type
+            */
+            void allocate_shared_send_buffers(std::size_t const (&sizes)[27]) {
+                assert(uses_shared_memory());
+                m_shared.free_window();
+                constexpr std::size_t alignment = 64;
+                auto align = [](std::size_t size) { return (size + alignment - 1) / alignment * alignment; };
+                // the offsets of the buffers are stored at the beginning of the segment, to be read by the peers
+                std::ptrdiff_t offsets[27];
+                std::size_t total = align(sizeof(offsets));
+                for (int i = 0; i < 27; ++i) {
+                    offsets[i] = total;
+                    total += align(sizes[i]);
+                }
+                char *base;
+                MPI_Win_allocate_shared(total, 1, MPI_INFO_NULL, m_shared.m_comm, &base, &m_shared.m_win);
+                std::memcpy(base, offsets, sizeof(offsets));
+                for (int i = 0; i < 27; ++i)
+                    m_shared.m_buffer[i] = base + offsets[i];
+                MPI_Win_fence(0, m_shared.m_win);
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            int id = translate()(i, j, k);
+                            if (m_shared.m_peer[id] == -1)
+                                continue;
+                            MPI_Aint size;
+                            int disp_unit;
+                            char *peer_base;
+                            MPI_Win_shared_query(m_shared.m_win, m_shared.m_peer[id], &size, &disp_unit, &peer_base);
+                            std::ptrdiff_t peer_offsets[27];
+                            std::memcpy(peer_offsets, peer_base, sizeof(peer_offsets));
+                            // the neighbor (i, j, k) sends to this process the buffer for its neighbor (-i, -j, -k)
+                            m_shared.m_peer_buffer[id] = peer_base + peer_offsets[translate()(-i, -j, -k)];
+                        }
+                MPI_Win_fence(0, m_shared.m_win);
+            }
+
+            char *shared_send_buffer(int I, int J, int K) const { return m_shared.m_buffer[translate()(I, J, K)]; }
+
+            /** Returns the buffer holding the data received from the neighbor (I, J, K) after Halo_Exchange_3D::wait:
+                the send buffer of the neighbor in the shared memory window if it is served through it, the registered
+                receive buffer otherwise. The send buffers of the window stay valid until
+                Halo_Exchange_3D::release_shared_send_buffers.
+            */
+            char const *receive_buffer(int I, int J, int K) const {
+                int id = translate()(I, J, K);
+                return m_shared.is_local(id) ? m_shared.m_peer_buffer[id] : m_recv_buffers.buffer(I, J, K);
+            }
+
+            /** Lets the node-local neighbors pack again into their send buffers. Must be called by all the processes
+                of the grid after the data of each exchange has been read (see Halo_Exchange_3D::receive_buffer) if the
+                send buffers are allocated in the shared memory window, and does nothing otherwise.
+            */
+            void release_shared_send_buffers() const {
+                if (has_shared_send_buffers())
+                    MPI_Win_fence(0, m_shared.m_win);
+            }
 
             /** Function to retrieve the grid from the pattern, from which user can query
                 location information.
@@ -337,6 +992,7 @@ namespace gridtools {
 
                 m_send_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
                 m_send_buffers.size(I, J, K) = s;
+                m_send_types[translate()(I, J, K)] = MPI_DATATYPE_NULL;
             }
 
             /** Function to register send buffers with the communication patter.
@@ -390,6 +1046,32 @@ namespace gridtools {
 
                 m_recv_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
                 m_recv_buffers.size(I, J, K) = s;
+                m_recv_types[translate()(I, J, K)] = MPI_DATATYPE_NULL;
+            }
+
+            /** Function to register the derived datatype of the messages sent to (Send == true) or received from the
+                neighbor (I, J, K), in place of a buffer. A message is a single element of the datatype, whose
+                displacements are absolute addresses (relative to MPI_BOTTOM), hence the data is sent directly from,
+                or received directly into, the memory the datatype describes. The datatype is used until a buffer or
+                another datatype is registered for the neighbor, and is not freed by the pattern. The neighbors served
+                through the shared memory window ignore it.
+
+                \param[in] type Committed datatype of the message
+                \param[in] s Number of bytes of the message, 0 if there is no message
+                \param[in] I Relative coordinates of the neighbor along the first dimension
+                \param[in] J Relative coordinates of the neighbor along the second dimension
+                \param[in] K Relative coordinates of the neighbor along the third dimension
+            */
+            template <bool Send>
+            void register_datatype(MPI_Datatype type, int s, int I, int J, int K) {
+                assert((I >= -1 && I <= 1));
+                assert((J >= -1 && J <= 1));
+                assert((K >= -1 && K <= 1));
+
+                sr_buffers &buffers = Send ? m_send_buffers : m_recv_buffers;
+                buffers.buffer(I, J, K) = nullptr;
+                buffers.size(I, J, K) = s;
+                (Send ? m_send_types : m_recv_types)[translate()(I, J, K)] = type;
             }
 
             /** Function to register buffers for received data with the communication patter.
@@ -549,6 +1231,15 @@ namespace gridtools {
             }
 
             void post_receives() {
+                count_messages<false>();
+                // the receives are posted together with the sends
+                if (uses_neighborhood_collectives())
+                    return;
+                if (m_use_persistent_requests) {
+                    start_persistent<false>();
+                    return;
+                }
+
                 /* Posting receives face -1
                  */
                 if (m_proc_grid.template proc<1, 0, -1>() != -1) {
@@ -667,6 +1358,23 @@ namespace gridtools {
             }
 
             void do_sends() {
+                // the packed send buffers are made available to the node-local neighbors
+                if (has_shared_send_buffers())
+                    MPI_Win_fence(0, m_shared.m_win);
+
+                count_messages<true>();
+                if (uses_neighborhood_collectives())
+                    start_collective();
+                else if (m_use_persistent_requests)
+                    start_persistent<true>();
+                else
+                    perform_isends();
+                start_progress_thread();
+            }
+
+          private:
+            // sends the messages to all the neighbors with MPI_Isend
+            void perform_isends() {
                 /* Sending data face -1
                  */
                 if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
@@ -784,6 +1492,7 @@ namespace gridtools {
                 }
             }
 
+          public:
             /** When called this function initiate the data exchabge. When the
                 function returns the data has to be considered already to be
                 transfered. Buffers should not be considered safe to access
@@ -813,6 +1522,212 @@ namespace gridtools {
             }
 
             void wait() {
+                if (m_progress.m_thread.joinable()) {
+                    // MPI must not be called while the progress thread is running
+                    auto start = std::chrono::steady_clock::now();
+                    m_progress.join();
+                    m_wait_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    return;
+                }
+                m_wait_start = MPI_Wtime();
+                wait_for_messages();
+                m_wait_time += MPI_Wtime() - m_wait_start;
+            }
+
+            /** Selects whether the exchanges are driven by a dedicated progress thread, started by
+                Halo_Exchange_3D::do_sends and joined by Halo_Exchange_3D::wait, instead of progressing only within
+                Halo_Exchange_3D::wait. The thread completes the messages with MPI_Testsome as they arrive and reports
+                each neighbor whose data is available through Halo_Exchange_3D::received and the callback set with
+                Halo_Exchange_3D::on_receive, such that the computation can overlap with the communication and use
+                the data of a neighbor before the others have arrived. The thread runs in addition to the compute
+                threads, which should be one fewer than the cores available to the process. The time waited for each
+                neighbor is not measured. Requires MPI to be initialized with at least MPI_THREAD_SERIALIZED (as
+                gcl::init does), and the other threads must not call MPI while an exchange is in progress. Must not be
+                called while an exchange is in progress.
+
+                \param[in] value true to use a progress thread
+            */
+            void use_progress_thread(bool value) {
+                if (value) {
+                    int provided;
+                    MPI_Query_thread(&provided);
+                    if (provided < MPI_THREAD_SERIALIZED)
+                        throw std::runtime_error("The progress thread of the halo exchange requires MPI to be "
+                                                 "initialized with MPI_THREAD_SERIALIZED or higher.");
+                }
+                m_progress.m_enabled = value;
+            }
+
+            bool uses_progress_thread() const { return m_progress.m_enabled; }
+
+            /** Sets the function called by the progress thread with the relative coordinates (I, J, K) of each
+                neighbor whose data has been received, before Halo_Exchange_3D::wait returns. It runs concurrently to
+                the other threads and must not call MPI.
+            */
+            void on_receive(std::function<void(int, int, int)> callback) {
+                m_progress.m_callback = std::move(callback);
+            }
+
+            /** Returns whether the data of the neighbor (I, J, K) of the exchange in progress with the progress
+                thread has been received and reported to the callback. The flags are cleared when the next exchange
+                starts.
+            */
+            bool received(int I, int J, int K) const {
+                return m_progress.m_received[translate()(I, J, K)].load(std::memory_order_acquire);
+            }
+
+            /** Starts a pipelined exchange, in place of Halo_Exchange_3D::start_exchange, by posting the receives
+                from all the neighbors. The message to each neighbor is then sent with Halo_Exchange_3D::send_to as
+                soon as its buffer is filled, and the messages from the neighbors are completed one at a time with
+                Halo_Exchange_3D::wait_any, such that filling the buffers, the transfers and the use of the received
+                data overlap. The point-to-point and the persistent requests are supported, not the neighborhood
+                collective nor the progress thread, which start all the messages at once.
+            */
+            void start_pipeline() {
+                assert(!uses_neighborhood_collectives() && !m_progress.m_enabled);
+                assert(!m_pipeline.m_sending && m_pipeline.m_requests.empty());
+                m_pipeline.m_receives = 0;
+                for (int k = -1; k <= 1; ++k)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int i = -1; i <= 1; ++i) {
+                            if (!has_message<false>(i, j, k))
+                                continue;
+                            count_message<false>(i, j, k);
+                            if (m_use_persistent_requests) {
+                                // the handles of persistent requests are not modified by the completion
+                                MPI_Request &request = persistent_request<false>(i, j, k);
+                                MPI_Start(&request);
+                                m_pipeline.m_requests.push_back(request);
+                            } else {
+                                auto [data, count, type] = message<false>(i, j, k);
+                                m_pipeline.m_requests.push_back(MPI_REQUEST_NULL);
+                                MPI_Irecv(data,
+                                    count,
+                                    type,
+                                    m_proc_grid.proc(i, j, k),
+                                    tag(-i, -j, -k),
+                                    m_proc_grid.communicator(),
+                                    &m_pipeline.m_requests.back());
+                            }
+                            m_pipeline.m_source.push_back(translate()(i, j, k));
+                            ++m_pipeline.m_receives;
+                        }
+                m_pipeline.m_sending = true;
+            }
+
+            /** Sends the message to the neighbor (I, J, K) of the pipelined exchange started with
+                Halo_Exchange_3D::start_pipeline, whose buffer must not be modified until Halo_Exchange_3D::wait_any
+                returns false. Must be called once for each neighbor, before the first call to
+                Halo_Exchange_3D::wait_any.
+            */
+            void send_to(int I, int J, int K) {
+                assert(m_pipeline.m_sending);
+                if (!has_message<true>(I, J, K))
+                    return;
+                count_message<true>(I, J, K);
+                if (m_use_persistent_requests) {
+                    MPI_Request &request = persistent_request<true>(I, J, K);
+                    MPI_Start(&request);
+                    m_pipeline.m_requests.push_back(request);
+                } else {
+                    auto [data, count, type] = message<true>(I, J, K);
+                    m_pipeline.m_requests.push_back(MPI_REQUEST_NULL);
+                    MPI_Isend(data,
+                        count,
+                        type,
+                        m_proc_grid.proc(I, J, K),
+                        tag(I, J, K),
+                        m_proc_grid.communicator(),
+                        &m_pipeline.m_requests.back());
+                }
+                m_pipeline.m_source.push_back(-1);
+            }
+
+            /** Waits for the data of one more neighbor of the pipelined exchange and returns its relative
+                coordinates (I, J, K), in the order of arrival. The neighbors served through the shared memory window
+                are returned first, once all the processes of the node have sent their messages. Returns false, after
+                completing the sends, when the data of all the neighbors has been returned. The time waited is
+                accounted as in Halo_Exchange_3D::wait.
+            */
+            bool wait_any(int &I, int &J, int &K) {
+                double start = MPI_Wtime();
+                if (m_pipeline.m_sending) {
+                    m_pipeline.m_sending = false;
+                    // the filled send buffers are made available to the node-local neighbors
+                    if (has_shared_send_buffers()) {
+                        MPI_Win_fence(0, m_shared.m_win);
+                        for (int id = 0; id < 27; ++id) {
+                            int i, j, k;
+                            neighbor(id, i, j, k);
+                            if (id != 13 && m_proc_grid.proc(i, j, k) != -1 && m_recv_buffers.size(i, j, k) &&
+                                m_shared.is_local(id))
+                                m_pipeline.m_local.push_back(id);
+                        }
+                    }
+                }
+                int source = -1;
+                if (!m_pipeline.m_local.empty()) {
+                    source = m_pipeline.m_local.back();
+                    m_pipeline.m_local.pop_back();
+                }
+                while (source == -1 && m_pipeline.m_receives) {
+                    int index;
+                    auto &requests = m_pipeline.m_requests;
+                    MPI_Waitany(requests.size(), requests.data(), &index, MPI_STATUS_IGNORE);
+                    source = m_pipeline.m_source[index];
+                    m_pipeline.m_source[index] = -1;
+                    if (source != -1) {
+                        --m_pipeline.m_receives;
+                        m_statistics[source].wait_time += MPI_Wtime() - start;
+                    }
+                }
+                if (source == -1) {
+                    MPI_Waitall(m_pipeline.m_requests.size(), m_pipeline.m_requests.data(), MPI_STATUSES_IGNORE);
+                    m_pipeline.m_requests.clear();
+                    m_pipeline.m_source.clear();
+                } else {
+                    neighbor(source, I, J, K);
+                }
+                m_wait_time += MPI_Wtime() - start;
+                return source != -1;
+            }
+
+            /** Returns the statistics of the messages exchanged with the neighbor (I, J, K).
+             */
+            neighbor_statistics const &statistics(int I, int J, int K) const {
+                return m_statistics[translate()(I, J, K)];
+            }
+
+            /** Returns the total time [s] spent in Halo_Exchange_3D::wait, which includes the load imbalance with
+                the neighbors.
+             */
+            double wait_time() const { return m_wait_time; }
+
+            void reset_statistics() {
+                for (auto &stats : m_statistics)
+                    stats = {};
+                m_wait_time = 0;
+            }
+
+          private:
+            void wait_for_messages() {
+                if (uses_neighborhood_collectives()) {
+                    MPI_Wait(&m_collective.m_request, MPI_STATUS_IGNORE);
+                    return;
+                }
+                if (m_use_persistent_requests) {
+                    // completes the requests one at a time to time the receive from each neighbor
+                    auto &active = m_persistent.m_active;
+                    for (std::size_t n = 0; n != active.size(); ++n) {
+                        int index;
+                        MPI_Waitany(active.size(), active.data(), &index, MPI_STATUS_IGNORE);
+                        if (index != MPI_UNDEFINED && m_persistent.m_source[index] != -1)
+                            m_statistics[m_persistent.m_source[index]].wait_time += MPI_Wtime() - m_wait_start;
+                    }
+                    active.clear();
+                    m_persistent.m_source.clear();
+                    return;
+                }
 
                 wait_for_sends();
 
@@ -11,6 +11,8 @@
 
 #include <cassert>
 #include <cmath>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 
 #include <mpi.h>
@@ -243,5 +245,150 @@ namespace gridtools {
             auto coordinates(uint_t i) const { return m_coordinates[i]; }
             auto dimensions(uint_t i) const { return m_dimensions[i]; }
         };
+
+        /** The dimensions of a 3D process grid chosen by gcl::choose_process_grid: `dims` processes along each
+            dimension, in blocks of `node_dims` processes running on the same node.
+        */
+        struct process_grid_dims {
+            array<int, 3> dims;
+            array<int, 3> node_dims;
+        };
+
+        namespace proc_grids_3D_impl_ {
+            // the volume of the halos exchanged through the faces between `blocks` blocks along each dimension
+            inline double halo_volume(array<int, 3> const &blocks,
+                array<int, 3> const &domain,
+                array<int, 3> const &halo_widths,
+                boollist<3> const &periodic) {
+                double res = 0;
+                for (int d = 0; d < 3; ++d) {
+                    int cuts = blocks[d] - 1 + (periodic.value(d) && blocks[d] > 1);
+                    double face = halo_widths[d];
+                    for (int e = 0; e < 3; ++e)
+                        if (e != d)
+                            face *= domain[e];
+                    res += cuts * face;
+                }
+                return res;
+            }
+
+            // calls f with the factorizations of n in 3 factors, which match the nonzero entries of `fixed`
+            template <class F>
+            void for_each_factorization(int n, array<int, 3> const &fixed, F const &f) {
+                for (int a = 1; a <= n; ++a)
+                    for (int b = 1; n % a == 0 && b <= n / a; ++b) {
+                        array<int, 3> factors = {a, b, n / a / b};
+                        if (n / a % b == 0 && (!fixed[0] || fixed[0] == factors[0]) &&
+                            (!fixed[1] || fixed[1] == factors[1]) && (!fixed[2] || fixed[2] == factors[2]))
+                            f(factors);
+                    }
+            }
+        } // namespace proc_grids_3D_impl_
+
+        /**
+            @brief Chooses the dimensions of a 3D process grid of `nprocs` processes, running `node_size` processes per
+            node, for a global domain of `domain` points with halos of `halo_widths` points (both sides together).
+
+            The grid minimizes the volume of the halos exchanged between the nodes, then the total volume of the
+            halos exchanged between the processes. The processes of a node form a block of `node_dims` processes; if
+            no block of `node_size` processes fits the grid, the blocks are single processes. The nonzero entries of
+            `dims` are kept, as by MPI_Dims_create: the dimensions without halos are split at no cost, hence they are
+            usually fixed (for instance to 1 to keep the columns of the domain in a process). Throws
+            std::runtime_error if `nprocs` processes do not fit the nonzero entries of `dims`.
+        */
+        inline process_grid_dims choose_process_grid(int nprocs,
+            int node_size,
+            array<int, 3> const &domain,
+            array<int, 3> const &halo_widths,
+            boollist<3> const &periodic,
+            array<int, 3> const &dims = {0, 0, 0}) {
+            using namespace proc_grids_3D_impl_;
+            bool found = false;
+            process_grid_dims res;
+            double best[2];
+            for_each_factorization(nprocs, dims, [&](array<int, 3> const &grid) {
+                double total = halo_volume(grid, domain, halo_widths, periodic);
+                for_each_factorization(node_size, {0, 0, 0}, [&](array<int, 3> const &node) {
+                    if (grid[0] % node[0] || grid[1] % node[1] || grid[2] % node[2])
+                        return;
+                    double inter_node = halo_volume(
+                        {grid[0] / node[0], grid[1] / node[1], grid[2] / node[2]}, domain, halo_widths, periodic);
+                    if (found && (inter_node > best[0] || (inter_node == best[0] && total >= best[1])))
+                        return;
+                    found = true;
+                    best[0] = inter_node;
+                    best[1] = total;
+                    res = {grid, node};
+                });
+            });
+            if (found)
+                return res;
+            if (node_size != 1)
+                return choose_process_grid(nprocs, 1, domain, halo_widths, periodic, dims);
+            throw std::runtime_error("No process grid of " + std::to_string(nprocs) +
+                                     " processes matches the given dimensions");
+        }
+
+        /**
+            @brief Makes a 3D Cartesian communicator of the processes of `comm` with the grid chosen by
+            gcl::choose_process_grid, for a global domain of `domain` points with halos of `halo_widths` points.
+
+            If all the nodes (as given by MPI_Comm_split_type) run the same number of processes, the processes of a
+            node are placed in a compact block of the grid, so that most of the halos are exchanged within the nodes.
+            `reorder` is passed to MPI_Cart_create, to let the MPI implementation renumber the processes further. Must
+            be called by all the processes of `comm`. The communicator is freed by the caller with MPI_Comm_free.
+        */
+        inline MPI_Comm make_process_grid_communicator(MPI_Comm comm,
+            array<int, 3> const &domain,
+            array<int, 3> const &halo_widths,
+            boollist<3> const &periodic,
+            array<int, 3> const &dims = {0, 0, 0},
+            bool reorder = false) {
+            int nprocs, rank;
+            MPI_Comm_size(comm, &nprocs);
+            MPI_Comm_rank(comm, &rank);
+
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+            int node_size, node_rank;
+            MPI_Comm_size(node_comm, &node_size);
+            MPI_Comm_rank(node_comm, &node_rank);
+            // the nodes are numbered in the order of their first processes
+            MPI_Comm leaders;
+            MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders);
+            int node = 0;
+            if (leaders != MPI_COMM_NULL) {
+                MPI_Comm_rank(leaders, &node);
+                MPI_Comm_free(&leaders);
+            }
+            MPI_Bcast(&node, 1, MPI_INT, 0, node_comm);
+            MPI_Comm_free(&node_comm);
+            int node_sizes[2] = {node_size, -node_size};
+            MPI_Allreduce(MPI_IN_PLACE, node_sizes, 2, MPI_INT, MPI_MAX, comm);
+            bool uniform = node_sizes[0] == -node_sizes[1];
+
+            auto grid = choose_process_grid(nprocs, uniform ? node_size : 1, domain, halo_widths, periodic, dims);
+            int block = node, local = node_rank;
+            if (grid.node_dims[0] * grid.node_dims[1] * grid.node_dims[2] == 1) {
+                block = rank;
+                local = 0;
+            }
+            // the coordinates of the process: those of the block of its node, then those within the block
+            int coords[3];
+            for (int d = 2; d >= 0; --d) {
+                int blocks = grid.dims[d] / grid.node_dims[d];
+                coords[d] = block % blocks * grid.node_dims[d] + local % grid.node_dims[d];
+                block /= blocks;
+                local /= grid.node_dims[d];
+            }
+            // MPI_Cart_create numbers the processes in row-major order of the coordinates
+            MPI_Comm ordered;
+            MPI_Comm_split(comm, 0, (coords[0] * grid.dims[1] + coords[1]) * grid.dims[2] + coords[2], &ordered);
+            int period[3] = {periodic.value(0), periodic.value(1), periodic.value(2)};
+            MPI_Comm res;
+            MPI_Cart_create(ordered, 3, &grid.dims[0], period, reorder, &res);
+            MPI_Comm_free(&ordered);
+            return res;
+        }
     } // namespace gcl
 } // namespace gridtools
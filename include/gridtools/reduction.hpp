@@ -11,3 +11,4 @@
 
 #include "reduction/frontend.hpp"
 #include "reduction/functions.hpp"
+#include "reduction/reduce.hpp"
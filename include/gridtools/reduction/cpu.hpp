@@ -10,18 +10,62 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <type_traits>
+#include <vector>
 
 #include "../common/defs.hpp"
 #include "functions.hpp"
+#include "segment.hpp"
 
 namespace gridtools {
     namespace reduction {
         struct cpu {};
 
+        /**
+         * Like `cpu`, but the result does not depend on the number of threads or on the scheduling.
+         *
+         * The buffer is split into chunks of a fixed size. Each chunk is reduced with a fixed number of independent
+         * partial results, and the partial results of the chunks are combined along a fixed-shape binary tree.
+         * Hence the order of the floating-point operations depends only on the size of the buffer.
+         */
+        struct cpu_reproducible : cpu {};
+
+        namespace cpu_impl_ {
+            using segment_impl_::chunk_size;
+            using segment_impl_::reduce_segment;
+            using segment_impl_::single_reducer;
+
+            /*
+             * Reduces `num_rows` rows of `row_length` elements, separated by `row_stride` elements. The rows are split
+             * into chunks of a fixed size that are reduced in parallel. The results of the chunks are combined along
+             * a fixed-shape binary tree, hence the result does not depend on the number of threads.
+             */
+            template <class Reducer, class T>
+            auto reduce_rows(
+                Reducer const &reducer, T const *buff, size_t num_rows, size_t row_length, size_t row_stride) {
+                assert(num_rows && row_length);
+                using acc_t = decltype(reducer.init(*buff, 0));
+                size_t chunks_per_row = (row_length + chunk_size - 1) / chunk_size;
+                size_t num_chunks = num_rows * chunks_per_row;
+                std::vector<acc_t> partials(num_chunks);
+#pragma omp parallel for
+                for (size_t i = 0; i < num_chunks; ++i) {
+                    size_t offset = i / chunks_per_row * row_stride;
+                    size_t begin = i % chunks_per_row * chunk_size;
+                    partials[i] = reduce_segment(
+                        reducer, buff, offset + begin, offset + std::min(begin + chunk_size, row_length));
+                }
+                for (size_t step = 1; step < num_chunks; step *= 2)
+                    for (size_t i = 0; i + step < num_chunks; i += 2 * step)
+                        reducer.merge(partials[i], partials[i + step]);
+                return partials[0];
+            }
+        } // namespace cpu_impl_
+
         template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, plus, T const *buff, size_t n) {
-#pragma omp parallel for reduction(+ : res)
+#pragma omp parallel for simd reduction(+ : res)
             for (size_t i = 0; i < n; i++)
                 res += buff[i];
             return res;
@@ -29,7 +73,7 @@ namespace gridtools {
 
         template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, mul, T const *buff, size_t n) {
-#pragma omp parallel for reduction(* : res)
+#pragma omp parallel for simd reduction(* : res)
             for (size_t i = 0; i < n; i++)
                 res *= buff[i];
             return res;
@@ -37,7 +81,7 @@ namespace gridtools {
 
         template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, bitwise_and, T const *buff, size_t n) {
-#pragma omp parallel for reduction(& : res)
+#pragma omp parallel for simd reduction(& : res)
             for (size_t i = 0; i < n; i++)
                 res &= buff[i];
             return res;
@@ -45,7 +89,7 @@ namespace gridtools {
 
         template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, bitwise_or, T const *buff, size_t n) {
-#pragma omp parallel for reduction(| : res)
+#pragma omp parallel for simd reduction(| : res)
             for (size_t i = 0; i < n; i++)
                 res |= buff[i];
             return res;
@@ -53,13 +97,36 @@ namespace gridtools {
 
         template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, bitwise_xor, T const *buff, size_t n) {
-#pragma omp parallel for reduction(^ : res)
+#pragma omp parallel for simd reduction(^ : res)
             for (size_t i = 0; i < n; i++)
                 res ^= buff[i];
             return res;
         }
 
-        template <class F, class T>
+        template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+        T reduction_reduce(cpu, T res, min, T const *buff, size_t n) {
+#pragma omp parallel for simd reduction(min : res)
+            for (size_t i = 0; i < n; i++)
+                res = buff[i] < res ? buff[i] : res;
+            return res;
+        }
+
+        template <class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+        T reduction_reduce(cpu, T res, max, T const *buff, size_t n) {
+#pragma omp parallel for simd reduction(max : res)
+            for (size_t i = 0; i < n; i++)
+                res = buff[i] > res ? buff[i] : res;
+            return res;
+        }
+
+        // user functors on arithmetic types: several independent partial results per chunk, such that the compiler
+        // can map them to SIMD lanes
+        template <class F, class T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+        T reduction_reduce(cpu, T res, F f, T const *buff, size_t n) {
+            return n ? f(res, cpu_impl_::reduce_rows(cpu_impl_::single_reducer<F>{f}, buff, 1, n, n)) : res;
+        }
+
+        template <class F, class T, std::enable_if_t<!std::is_arithmetic_v<T>, int> = 0>
         T reduction_reduce(cpu, T res, F, T const *buff, size_t n) {
             static_assert(std::is_empty<F>(), "OpenMP reduction supports only stateless functors.");
             static_assert(
@@ -71,6 +138,17 @@ namespace gridtools {
             return res;
         }
 
+        template <class F, class T>
+        T reduction_reduce(cpu_reproducible, T res, F f, T const *buff, size_t n) {
+            return n ? f(res, cpu_impl_::reduce_rows(cpu_impl_::single_reducer<F>{f}, buff, 1, n, n)) : res;
+        }
+
+        template <class Reducer, class T>
+        auto reduction_reduce_rows(
+            cpu, Reducer const &reducer, T const *buff, size_t num_rows, size_t row_length, size_t row_stride) {
+            return cpu_impl_::reduce_rows(reducer, buff, num_rows, row_length, row_stride);
+        }
+
         inline size_t reduction_round_size(cpu, size_t size) { return size; }
         inline size_t reduction_allocation_size(cpu, size_t size) { return size; }
 
@@ -9,17 +9,22 @@
  */
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdlib>
+#include <functional>
 #include <memory>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
+#include "../common/array.hpp"
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/allocator.hpp"
 #include "../storage/traits.hpp"
+#include "functions.hpp"
 
 namespace gridtools {
     namespace reduction {
@@ -32,6 +37,133 @@ namespace gridtools {
             template <class Sizes>
             using zeros_type = decltype(zeros(std::declval<Sizes const &>()));
 
+            template <class F>
+            struct map_f {
+                template <class T>
+                T operator()(F const &, T const &x) const {
+                    return x;
+                }
+            };
+
+            template <class F, class Map>
+            struct map_f<transformed_f<F, Map>> {
+                template <class T>
+                T operator()(transformed_f<F, Map> const &f, T const &x) const {
+                    return f.m_map(x);
+                }
+            };
+
+            template <class F>
+            F const &get_reduce_f(F const &f) {
+                return f;
+            }
+
+            template <class F, class Map>
+            F const &get_reduce_f(transformed_f<F, Map> const &f) {
+                return f.m_f;
+            }
+
+            // evaluates several reductions in a single pass, see `reduction_reduce_rows` for the reducer concept
+            template <class T, class... Fs>
+            struct fused_reducer {
+                using acc_t = std::array<T, sizeof...(Fs)>;
+                std::tuple<Fs...> m_fs;
+
+                template <size_t... Is>
+                acc_t init(T const &x, std::index_sequence<Is...>) const {
+                    return {map_f<Fs>()(std::get<Is>(m_fs), x)...};
+                }
+                acc_t init(T const &x, size_t) const { return init(x, std::index_sequence_for<Fs...>()); }
+
+                template <size_t... Is>
+                void step(acc_t &acc, T const &x, std::index_sequence<Is...>) const {
+                    ((acc[Is] = get_reduce_f(std::get<Is>(m_fs))(acc[Is], map_f<Fs>()(std::get<Is>(m_fs), x))), ...);
+                }
+                void step(acc_t &acc, T const &x, size_t) const { step(acc, x, std::index_sequence_for<Fs...>()); }
+
+                template <size_t... Is>
+                void merge(acc_t &acc, acc_t const &other, std::index_sequence<Is...>) const {
+                    ((acc[Is] = get_reduce_f(std::get<Is>(m_fs))(acc[Is], other[Is])), ...);
+                }
+                void merge(acc_t &acc, acc_t const &other) const {
+                    merge(acc, other, std::index_sequence_for<Fs...>());
+                }
+            };
+
+            // the first position of the minimum (or the maximum, if `Less` is `std::greater`)
+            template <class T, class Less>
+            struct arg_reducer {
+                using acc_t = std::pair<T, size_t>;
+
+                acc_t init(T const &x, size_t i) const { return {x, i}; }
+                void step(acc_t &acc, T const &x, size_t i) const {
+                    if (Less()(x, acc.first))
+                        acc = {x, i};
+                }
+                void merge(acc_t &acc, acc_t const &other) const {
+                    if (Less()(other.first, acc.first) ||
+                        (!Less()(acc.first, other.first) && other.second < acc.second))
+                        acc = other;
+                }
+            };
+
+            // the host backends provide `reduction_reduce_rows`, which visits the compute domain only
+            template <class Backend, class T, class = void>
+            struct has_reduce_rows : std::false_type {};
+
+            template <class Backend, class T>
+            struct has_reduce_rows<Backend,
+                T,
+                std::void_t<decltype(reduction_reduce_rows(Backend(),
+                    std::declval<fused_reducer<T, plus> const &>(),
+                    std::declval<T const *>(),
+                    size_t(),
+                    size_t(),
+                    size_t()))>> : std::true_type {};
+
+            /*
+             * The layout of a reducible buffer: the elements of the compute domain are `num_rows` rows of `row_length`
+             * elements separated by `row_stride` elements. The gaps are the padding of the innermost dimension.
+             */
+            template <size_t N>
+            struct geometry {
+                array<uint_t, N> lengths;
+                array<uint_t, N> strides;
+                size_t num_rows;
+                size_t row_length;
+                size_t row_stride;
+
+                array<int_t, N> index(size_t offset) const {
+                    array<int_t, N> res;
+                    array<bool, N> done = {};
+                    for (size_t n = 0; n != N; ++n) {
+                        // the dimension with the next largest stride
+                        size_t d = N;
+                        for (size_t i = 0; i != N; ++i)
+                            if (!done[i] && (d == N || strides[i] > strides[d]))
+                                d = i;
+                        done[d] = true;
+                        res[d] = offset / strides[d];
+                        offset %= strides[d];
+                    }
+                    return res;
+                }
+            };
+
+            template <class Layout, class Info>
+            geometry<Info::ndims> make_geometry(Info const &info) {
+                constexpr size_t n = Info::ndims;
+                geometry<n> res{info.lengths(), info.strides()};
+                size_t inner = Layout::find(n - 1);
+                res.row_length = res.lengths[inner];
+                res.row_stride = n > 1 ? res.strides[Layout::find(n - 2)] : res.row_length;
+                res.num_rows = 1;
+                for (size_t i = 0; i != n; ++i)
+                    if (i != inner)
+                        res.num_rows *= res.lengths[i];
+                return res;
+            }
+
             template <class Backend, class T, class Origin, class Strides, class StridesKind, class Sizes>
             struct reducible {
                 std::shared_ptr<void> m_alloc;
@@ -40,13 +172,68 @@ namespace gridtools {
                 size_t m_size;
                 Strides m_strides;
                 Sizes m_sizes;
+                geometry<tuple_util::size<Sizes>::value> m_geometry;
+
+                template <class Reducer>
+                auto reduce_rows(Reducer const &reducer) const {
+                    assert(m_geometry.num_rows && m_geometry.row_length);
+                    return reduction_reduce_rows(Backend(),
+                        reducer,
+                        m_origin(),
+                        m_geometry.num_rows,
+                        m_geometry.row_length,
+                        m_geometry.row_stride);
+                }
 
+                // true if the elements of the compute domain are the whole buffer
+                bool is_compact() const {
+                    return m_geometry.row_stride == m_geometry.row_length &&
+                           m_geometry.num_rows * m_geometry.row_length == m_size;
+                }
+
+                /**
+                 * Reduces the compute domain with `f`, starting from the neutral value. On the host backends the
+                 * padding of a buffer with holes is not visited, as in `reduce_many`; the other backends reduce the
+                 * whole buffer, where the padding holds the neutral value.
+                 */
                 template <class F>
                 auto reduce(F f) const {
                     assert(m_size);
+                    if constexpr (has_reduce_rows<Backend, T>::value) {
+                        if (!is_compact())
+                            return f(neutral_value, reduce_rows(fused_reducer<T, F>{{f}})[0]);
+                    }
                     return reduction_reduce(Backend(), neutral_value, f, m_origin(), m_size);
                 }
 
+                /**
+                 * Evaluates several reductions in a single pass over the compute domain and returns their results as
+                 * an `std::array`. The functors are either binary reduction functors or `transformed(f, map)`.
+                 * The padding is not visited and, unlike `reduce`, the results do not include the neutral value.
+                 * Only host backends are supported.
+                 */
+                template <class... Fs>
+                std::array<T, sizeof...(Fs)> reduce_many(Fs... fs) const {
+                    return reduce_rows(fused_reducer<T, Fs...>{{fs...}});
+                }
+
+                std::pair<T, T> minmax() const {
+                    auto res = reduce_many(min(), max());
+                    return {res[0], res[1]};
+                }
+
+                // the minimum and the index of its first occurrence
+                std::pair<T, array<int_t, tuple_util::size<Sizes>::value>> argmin() const {
+                    auto res = reduce_rows(arg_reducer<T, std::less<>>());
+                    return {res.first, m_geometry.index(res.second)};
+                }
+
+                // the maximum and the index of its first occurrence
+                std::pair<T, array<int_t, tuple_util::size<Sizes>::value>> argmax() const {
+                    auto res = reduce_rows(arg_reducer<T, std::greater<>>());
+                    return {res.first, m_geometry.index(res.second)};
+                }
+
                 friend Strides sid_get_strides(reducible const &obj) { return obj.m_strides; }
                 friend Origin sid_get_origin(reducible const &obj) { return {obj.m_origin}; }
                 friend zeros_type<Sizes> sid_get_lower_bounds(reducible const &obj) { return zeros(obj.m_sizes); }
@@ -56,10 +243,9 @@ namespace gridtools {
             template <class Backend, class T, class Origin, class Strides, class StridesKind, class Sizes>
             StridesKind sid_get_strides_kind(reducible<Backend, T, Origin, Strides, StridesKind, Sizes> const &);
 
+            // the buffer is pooled by `cached_allocator`, hence the storage memory pool is bypassed here
             template <class StorageTraits>
-            struct alloc_fun {
-                auto operator()(size_t size) const { return storage::traits::allocate<StorageTraits, char>(size); }
-            };
+            using alloc_fun = storage::traits::allocate_f<StorageTraits, char>;
 
             template <class Backend, class StorageTraits, class Id = void, class T, class... Dims>
             auto make_reducible(T const &neutral_value, Dims... dims) {
@@ -87,7 +273,8 @@ namespace gridtools {
                     std::move(origin),
                     rounded_size,
                     std::move(strides),
-                    std::move(lengths)};
+                    std::move(lengths),
+                    make_geometry<storage::traits::layout_type<StorageTraits, sizeof...(Dims)>>(info)};
             }
         } // namespace frontend_impl_
         using frontend_impl_::make_reducible;
@@ -55,5 +55,20 @@ namespace gridtools {
                 return x ^ y;
             }
         };
+
+        /**
+         * Reduces the values `map(x)` with `f` instead of `x`, e.g. `transformed(plus(), square)` is the sum of
+         * squares. Accepted by `reducible::reduce_many`.
+         */
+        template <class F, class Map>
+        struct transformed_f {
+            F m_f;
+            Map m_map;
+        };
+
+        template <class F, class Map>
+        transformed_f<F, Map> transformed(F f, Map map) {
+            return {f, map};
+        }
     } // namespace reduction
 } // namespace gridtools
@@ -22,6 +22,17 @@ namespace gridtools {
             return res;
         }
 
+        template <class Reducer, class T>
+        auto reduction_reduce_rows(
+            naive, Reducer const &reducer, T const *buff, size_t num_rows, size_t row_length, size_t row_stride) {
+            auto res = reducer.init(buff[0], 0);
+            for (size_t row = 0; row != num_rows; ++row)
+                for (size_t i = row * row_stride, end = i + row_length; i != end; ++i)
+                    if (i)
+                        reducer.step(res, buff[i], i);
+            return res;
+        }
+
         inline size_t reduction_round_size(naive, size_t size) { return size; }
         inline size_t reduction_allocation_size(naive, size_t size) { return size; }
 
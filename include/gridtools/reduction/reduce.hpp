@@ -0,0 +1,125 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+#include "../common/hymap.hpp"
+#include "../meta.hpp"
+#include "../sid/concept.hpp"
+#include "segment.hpp"
+
+/**
+ *  Reduction over an arbitrary host SID
+ *  ------------------------------------
+ *
+ *  `reduction::reduce(sid, f, neutral, lower, upper)` reduces with `f` the elements of `sid` within the box
+ *  [lower, upper), using the strides of the SID. `lower` and `upper` are hymaps with the same keys as the strides (e.g.
+ *  tuples for data stores). No buffer is allocated, hence the norm of an existing field (a data store, a python
+ *  buffer, ...) costs a single pass over its memory. The bounds are mandatory: the bounds of a data store cover its
+ *  halos, which usually hold stale values and must not enter the result.
+ *
+ *  The dimension with the smallest stride is the inner one. The domain is split into chunks along it, which are
+ *  reduced in parallel (with OpenMP, if enabled) with the same kernel as `reducible` (see segment.hpp). The partial
+ *  results of the chunks are combined in a fixed order, hence the result does not depend on the number of threads.
+ *  The dimensions that are missing in the bounds are not iterated. The pointers of the SID have to be raw host
+ *  pointers.
+ */
+
+namespace gridtools {
+    namespace reduction {
+        namespace reduce_impl_ {
+            struct dim {
+                std::ptrdiff_t stride;
+                std::ptrdiff_t lower;
+                std::ptrdiff_t size;
+            };
+
+            // the dimensions without bounds (e.g. masked dimensions of data stores) are not iterated
+            template <class Key, class Bounds>
+            std::ptrdiff_t get_bound(Bounds const &bounds, std::ptrdiff_t default_value) {
+                if constexpr (has_key<Bounds, Key>::value)
+                    return at_key<Key>(bounds);
+                else
+                    return default_value;
+            }
+
+            template <class... Keys, class Strides, class Lower, class Upper>
+            std::array<dim, sizeof...(Keys)> make_dims(
+                meta::list<Keys...>, Strides const &strides, Lower const &lower, Upper const &upper) {
+                return {dim{std::ptrdiff_t(sid::get_stride<Keys>(strides)),
+                    get_bound<Keys>(lower, 0),
+                    get_bound<Keys>(upper, 1) - get_bound<Keys>(lower, 0)}...};
+            }
+
+            template <class T, class F, class Ptr, size_t N>
+            T reduce(T neutral, F f, Ptr ptr, std::array<dim, N> dims) {
+                static_assert(std::is_pointer_v<Ptr>, "reduction::reduce supports SIDs with raw pointers only");
+                size_t num_rows = 1;
+                for (auto const &d : dims) {
+                    if (d.size <= 0)
+                        return neutral;
+                    ptr += d.lower * d.stride;
+                    num_rows *= d.size;
+                }
+                if constexpr (N == 0) {
+                    return f(neutral, *ptr);
+                } else {
+                    // the dimension with the smallest stride goes innermost
+                    std::iter_swap(dims.begin(),
+                        std::min_element(dims.begin(), dims.end(), [](auto const &l, auto const &r) {
+                            return std::abs(l.stride) < std::abs(r.stride);
+                        }));
+                    auto inner = dims[0];
+                    num_rows /= inner.size;
+                    size_t chunks_per_row = (inner.size + segment_impl_::chunk_size - 1) / segment_impl_::chunk_size;
+                    size_t num_chunks = num_rows * chunks_per_row;
+                    std::vector<T> partials(num_chunks);
+#pragma omp parallel for
+                    for (size_t c = 0; c < num_chunks; ++c) {
+                        auto row_ptr = ptr;
+                        for (size_t row = c / chunks_per_row, d = 1; d != N; ++d) {
+                            row_ptr += std::ptrdiff_t(row % dims[d].size) * dims[d].stride;
+                            row /= dims[d].size;
+                        }
+                        size_t begin = c % chunks_per_row * segment_impl_::chunk_size;
+                        size_t n = std::min<size_t>(segment_impl_::chunk_size, inner.size - begin);
+                        row_ptr += std::ptrdiff_t(begin) * inner.stride;
+                        segment_impl_::single_reducer<F> reducer{f};
+                        if (inner.stride == 1)
+                            partials[c] = segment_impl_::reduce_segment(reducer, row_ptr, 0, n);
+                        else
+                            partials[c] = segment_impl_::reduce_segment(reducer, row_ptr, 0, n, inner.stride);
+                    }
+                    for (auto const &partial : partials)
+                        neutral = f(neutral, partial);
+                    return neutral;
+                }
+            }
+        } // namespace reduce_impl_
+
+        /**
+         * @brief Reduces the elements of `sid` within the box [lower, upper).
+         */
+        template <class Sid, class F, class T, class Lower, class Upper>
+        T reduce(Sid const &sid, F f, T neutral, Lower const &lower, Upper const &upper) {
+            static_assert(is_sid<Sid>::value);
+            return reduce_impl_::reduce(std::move(neutral),
+                f,
+                sid::get_origin(sid)(),
+                reduce_impl_::make_dims(get_keys<sid::strides_type<Sid>>(), sid::get_strides(sid), lower, upper));
+        }
+    } // namespace reduction
+} // namespace gridtools
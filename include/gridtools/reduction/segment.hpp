@@ -0,0 +1,78 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "../common/integral_constant.hpp"
+
+namespace gridtools {
+    namespace reduction {
+        namespace segment_impl_ {
+            // the host reductions split the data into chunks of this size, that are reduced in parallel
+            constexpr size_t chunk_size = 4096;
+            // the number of independent partial results within a chunk
+            constexpr size_t num_partials = 8;
+
+            /*
+             * A reducer defines how the elements are accumulated:
+             *   - `acc_t init(T const &x, size_t i)` makes an accumulator from the element `x` at the offset `i`;
+             *   - `void step(acc_t &acc, T const &x, size_t i)` adds the element `x` at the offset `i` to `acc`;
+             *   - `void merge(acc_t &acc, acc_t const &other)` merges `other`, which covers larger offsets, into `acc`.
+             */
+            template <class F>
+            struct single_reducer {
+                F m_f;
+
+                template <class T>
+                T init(T const &x, size_t) const {
+                    return x;
+                }
+                template <class T>
+                void step(T &acc, T const &x, size_t) const {
+                    acc = m_f(acc, x);
+                }
+                template <class T>
+                void merge(T &acc, T const &other) const {
+                    acc = m_f(acc, other);
+                }
+            };
+
+            /*
+             * Reduces the elements with the offsets [begin, end), which are `stride` elements apart, with a fixed number
+             * of independent partial results. The partial results are merged along a fixed-shape binary tree.
+             */
+            template <class Reducer, class T, class Stride = integral_constant<std::ptrdiff_t, 1>>
+            auto reduce_segment(Reducer const &reducer, T const *buff, size_t begin, size_t end, Stride stride = {}) {
+                auto at = [&](size_t i) -> T const & { return buff[std::ptrdiff_t(i) * std::ptrdiff_t(stride)]; };
+                using acc_t = decltype(reducer.init(*buff, 0));
+                if (end - begin < num_partials) {
+                    acc_t res = reducer.init(at(begin), begin);
+                    for (size_t i = begin + 1; i < end; ++i)
+                        reducer.step(res, at(i), i);
+                    return res;
+                }
+                acc_t partials[num_partials];
+                for (size_t j = 0; j != num_partials; ++j)
+                    partials[j] = reducer.init(at(begin + j), begin + j);
+                size_t i = begin + num_partials;
+                for (; i + num_partials <= end; i += num_partials)
+                    for (size_t j = 0; j != num_partials; ++j)
+                        reducer.step(partials[j], at(i + j), i + j);
+                for (size_t j = 0; i < end; ++i, ++j)
+                    reducer.step(partials[j], at(i), i);
+                for (size_t step = 1; step != num_partials; step *= 2)
+                    for (size_t j = 0; j < num_partials; j += 2 * step)
+                        reducer.merge(partials[j], partials[j + step]);
+                return partials[0];
+            }
+        } // namespace segment_impl_
+    } // namespace reduction
+} // namespace gridtools
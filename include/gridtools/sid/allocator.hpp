@@ -12,14 +12,13 @@
 #ifndef GT_SID_ALLOCATOR_HPP_
 #define GT_SID_ALLOCATOR_HPP_
 
-#include <map>
 #include <memory>
-#include <stack>
 #include <utility>
 #include <vector>
 
 #include "../common/defs.hpp"
 #include "../common/host_device.hpp"
+#include "../common/memory_pool.hpp"
 #include "../meta.hpp"
 #include "simple_ptr_holder.hpp"
 
@@ -49,8 +48,9 @@
  *
  *  Semantics:
  *    - `allocator` keeps the resources that are allocated and releases them in dtor.
- *    - `cached_allocator` keeps resources during its lifetime. On dtor it stashes the resources in the internal static
- *      storage. The newly created instances of `cached_allocator` will attempt to reuse the stashed resources.
+ *    - `cached_allocator` keeps resources during its lifetime. On dtor it stashes the resources in the process-wide
+ *      memory pool (see `common/memory_pool.hpp`). The newly created instances of `cached_allocator` (on any thread)
+ *      will attempt to reuse the stashed resources, rounding the requested sizes up to the pool size classes.
  *
  *  To make the simplest possible allocator one can do:
  *    `auto alloc = allocator(&std::make_unique<char[]>);`
@@ -61,37 +61,11 @@ namespace gridtools {
     namespace sid {
         namespace allocator_impl_ {
 
-            template <class Impl, class Ptr = decltype(std::declval<Impl const>()(size_t{}))>
-            struct cached_proxy_f;
-
-            template <class Impl, class T, class Deleter>
-            struct cached_proxy_f<Impl, std::unique_ptr<T, Deleter>> {
-                using ptr_t = std::unique_ptr<T, Deleter>;
-                using stack_t = std::stack<ptr_t>;
-
-                struct deleter_f {
-                    using pointer = typename ptr_t::pointer;
-                    Deleter m_deleter;
-                    stack_t &m_stack;
-
-                    void operator()(pointer ptr) const { m_stack.emplace(ptr, m_deleter); }
-                };
-                using cached_ptr_t = std::unique_ptr<T, deleter_f>;
-
+            template <class Impl>
+            struct cached_proxy_f {
                 Impl m_impl;
 
-                cached_ptr_t operator()(size_t size) const {
-                    static thread_local std::map<size_t, stack_t> stack_map;
-                    auto &stack = stack_map[size];
-                    ptr_t ptr;
-                    if (stack.empty()) {
-                        ptr = m_impl(size);
-                    } else {
-                        ptr = std::move(stack.top());
-                        stack.pop();
-                    }
-                    return {ptr.release(), {ptr.get_deleter(), stack}};
-                }
+                auto operator()(size_t size) const { return memory_pool_allocate(m_impl, size); }
             };
         } // namespace allocator_impl_
     }     // namespace sid
@@ -122,7 +96,6 @@ namespace gridtools {
                 template <class LazyT>
                 friend auto allocate(allocator &self, LazyT, size_t size) {
                     using type = typename LazyT::type;
-                    auto ptr = self.m_impl(sizeof(type) * size);
                     self.m_buffers.push_back(self.m_impl(sizeof(type) * size));
                     return simple_ptr_holder(reinterpret_cast<type *>(self.m_buffers.back().get()));
                 }
@@ -411,6 +411,17 @@ namespace gridtools {
             using make_split_view = meta::rename<aggregated_view,
                 meta::transform<make_split_view_item, meta::flatten<meta::transform<fuse_stage_rows, Matrices>>>>;
 
+            /**
+             *  A block epilogue is called by the host backends that support it (those with an overload of
+             *  `gridtools_backend_entry_point` taking it as a fifth argument) after all the stages have been computed
+             *  on a unit of work. It gets the box of the unit relative to the origin of the grid:
+             *  `epilogue(i_begin, i_size, j_begin, j_size, k_begin, k_size)`. The units of work are disjoint and
+             *  cover the compute domain. The epilogue is called concurrently for different units.
+             */
+            struct no_block_epilogue {
+                void operator()(int_t, int_t, int_t, int_t, int_t, int_t) const {}
+            };
+
             using core::is_backward;
             using core::is_forward;
             using core::is_parallel;
@@ -34,9 +34,9 @@ namespace gridtools {
         namespace cpu_ifirst_backend {
             template <class ThreadPool = thread_pool::omp>
             struct cpu_ifirst {
-                template <class Spec, class Grid, class DataStores>
+                template <class Spec, class Grid, class DataStores, class Epilogue>
                 friend void gridtools_backend_entry_point(
-                    cpu_ifirst, Spec, Grid const &grid, DataStores external_data_stores) {
+                    cpu_ifirst, Spec, Grid const &grid, DataStores external_data_stores, Epilogue const &epilogue) {
                     using thread_pool_t = ThreadPool; // workaround needed for nvc++ at least up to 23.3
                     using stages_t = be_api::make_split_view<Spec>;
                     using all_parrallel_t = typename meta::all_of<be_api::is_parallel,
@@ -90,7 +90,14 @@ namespace gridtools {
                         },
                         meta::rename<tuple, stages_t>());
 
-                    run_loops<thread_pool_t>(fuse_all_t(), grid, std::move(loops));
+                    run_loops<thread_pool_t>(fuse_all_t(), grid, std::move(loops), epilogue);
+                }
+
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(
+                    cpu_ifirst be, Spec spec, Grid const &grid, DataStores external_data_stores) {
+                    gridtools_backend_entry_point(
+                        be, spec, grid, std::move(external_data_stores), be_api::no_block_epilogue());
                 }
             };
         } // namespace cpu_ifirst_backend
@@ -97,8 +97,8 @@ namespace gridtools {
                     };
                 }
 
-                template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::true_type, Grid const &grid, Loops loops) {
+                template <class ThreadPool, class Grid, class Loops, class Epilogue>
+                void run_loops(std::true_type, Grid const &grid, Loops loops, Epilogue const &epilogue) {
                     execinfo info(ThreadPool(), grid);
                     int_t i_blocks = info.i_blocks();
                     int_t j_blocks = info.j_blocks();
@@ -106,7 +106,14 @@ namespace gridtools {
                     thread_pool::parallel_for_loop(
                         ThreadPool(),
                         [&](auto i, auto k, auto j) {
-                            tuple_util::for_each([block = info.block(i, j, k)](auto &&loop) { loop(block); }, loops);
+                            auto const block = info.block(i, j, k);
+                            tuple_util::for_each([&block](auto &&loop) { loop(block); }, loops);
+                            epilogue(i * info.i_block_size(),
+                                block.i_block_size,
+                                j * info.j_block_size(),
+                                block.j_block_size,
+                                k,
+                                1);
                         },
                         i_blocks,
                         k_size,
@@ -149,13 +156,20 @@ namespace gridtools {
                     };
                 }
 
-                template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::false_type, Grid const &grid, Loops loops) {
+                template <class ThreadPool, class Grid, class Loops, class Epilogue>
+                void run_loops(std::false_type, Grid const &grid, Loops loops, Epilogue const &epilogue) {
                     execinfo info(ThreadPool(), grid);
                     thread_pool::parallel_for_loop(
                         ThreadPool(),
                         [&](auto i, auto j) {
-                            tuple_util::for_each([block = info.block(i, j)](auto &&loop) { loop(block); }, loops);
+                            auto const block = info.block(i, j);
+                            tuple_util::for_each([&block](auto &&loop) { loop(block); }, loops);
+                            epilogue(i * info.i_block_size(),
+                                block.i_block_size,
+                                j * info.j_block_size(),
+                                block.j_block_size,
+                                0,
+                                grid.k_size());
                         },
                         info.i_blocks(),
                         info.j_blocks());
@@ -90,11 +90,18 @@ namespace gridtools {
                 class ThreadPool = thread_pool::omp>
             struct cpu_kfirst {};
 
-            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
+            template <class IBlockSize,
+                class JBlockSize,
+                class ThreadPool,
+                class Spec,
+                class Grid,
+                class DataStores,
+                class Epilogue>
             void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool>,
                 Spec,
                 Grid const &grid,
-                DataStores external_data_stores) {
+                DataStores external_data_stores,
+                Epilogue const &epilogue) {
                 using stages_t = be_api::make_split_view<Spec>;
 
                 auto alloc = sid::cached_allocator(&std::make_unique<char[]>);
@@ -145,10 +152,20 @@ namespace gridtools {
                         int_t j_size = bj + 1 == NBJ ? total_j - bj * JBlockSize::value : JBlockSize::value;
                         tuple_util::for_each(
                             [=](auto &&fun) GT_FORCE_INLINE_LAMBDA { fun(bi, bj, i_size, j_size); }, stage_loops);
+                        epilogue(bi * IBlockSize::value, i_size, bj * JBlockSize::value, j_size, 0, grid.k_size());
                     },
                     NBJ,
                     NBI);
             }
+
+            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
+            void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool> be,
+                Spec spec,
+                Grid const &grid,
+                DataStores external_data_stores) {
+                gridtools_backend_entry_point(
+                    be, spec, grid, std::move(external_data_stores), be_api::no_block_epilogue());
+            }
         } // namespace cpu_kfirst_backend
         using cpu_kfirst_backend::cpu_kfirst;
     } // namespace stencil
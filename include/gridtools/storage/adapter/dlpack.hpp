@@ -0,0 +1,311 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../../common/defs.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../meta/if.hpp"
+#include "../../sid/simple_ptr_holder.hpp"
+#include "../../sid/unknown_kind.hpp"
+#include "../data_store.hpp"
+
+#ifdef GT_CUDACC
+#include "../../common/cuda_runtime.hpp"
+#include "../../common/cuda_util.hpp"
+#endif
+
+/**
+ *  Zero-copy exchange of data stores and SIDs via DLPack
+ *  ------------------------------------------------------
+ *
+ *  `to_dlpack(ds)` exports a data store as a `DLManagedTensor`. The tensor shares the target memory of the data store
+ *  and keeps the data store alive until its deleter is called. The export is a write access on the target: the target
+ *  is synchronized and the host copy is marked as outdated, hence the writes of the consumer are seen by the next host
+ *  view. If the host is accessed while the consumer still writes to the tensor, the consumer writes are lost unless
+ *  the target is marked as modified again (e.g. with `ds->target_view()`) after them. Version 0.8 of the protocol
+ *  cannot express read-only tensors, hence data stores of const elements can only be exported with
+ *  `to_dlpack_versioned(ds)`, which produces a `DLManagedTensorVersioned` (version 1.0) with the read-only flag.
+ *
+ *  `dlpack::as_sid<T, Dim>(tensor)` takes the ownership of a `DLManagedTensor` or of a `DLManagedTensorVersioned`
+ *  (produced by any DLPack exporter) and makes a SID out of it. The tensor deleter is called when the last copy of the
+ *  SID is destroyed. Read-only tensors can only be imported with a const `T`.
+ *
+ *  The structures below are ABI compatible with `dlpack.h` (version 1.0), such that no dependency is required.
+ */
+
+namespace gridtools {
+    namespace dlpack {
+        enum DLDeviceType : std::int32_t {
+            kDLCPU = 1,
+            kDLCUDA = 2,
+            kDLCUDAHost = 3,
+            kDLROCM = 10,
+            kDLROCMHost = 11,
+            kDLCUDAManaged = 13,
+        };
+
+        struct DLDevice {
+            DLDeviceType device_type;
+            std::int32_t device_id;
+        };
+
+        enum DLDataTypeCode : std::uint8_t {
+            kDLInt = 0,
+            kDLUInt = 1,
+            kDLFloat = 2,
+            kDLBfloat = 4,
+            kDLComplex = 5,
+            kDLBool = 6,
+        };
+
+        struct DLDataType {
+            std::uint8_t code;
+            std::uint8_t bits;
+            std::uint16_t lanes;
+        };
+
+        struct DLTensor {
+            void *data;
+            DLDevice device;
+            std::int32_t ndim;
+            DLDataType dtype;
+            std::int64_t *shape;
+            std::int64_t *strides; // in elements, `nullptr` means compact row-major
+            std::uint64_t byte_offset;
+        };
+
+        struct DLManagedTensor {
+            DLTensor dl_tensor;
+            void *manager_ctx;
+            void (*deleter)(DLManagedTensor *self);
+        };
+
+        struct DLPackVersion {
+            std::uint32_t major;
+            std::uint32_t minor;
+        };
+
+        constexpr std::uint64_t DLPACK_FLAG_BITMASK_READ_ONLY = 1;
+
+        struct DLManagedTensorVersioned {
+            DLPackVersion version;
+            void *manager_ctx;
+            void (*deleter)(DLManagedTensorVersioned *self);
+            std::uint64_t flags;
+            DLTensor dl_tensor;
+        };
+
+        namespace dlpack_impl_ {
+            template <class T>
+            DLDataType make_dtype() {
+                using type = std::remove_cv_t<T>;
+                static_assert(std::is_arithmetic_v<type>, "DLPack supports arithmetic types only");
+                std::uint8_t code = std::is_same_v<type, bool>  ? kDLBool
+                                    : std::is_floating_point_v<type> ? kDLFloat
+                                    : std::is_signed_v<type>         ? kDLInt
+                                                                     : kDLUInt;
+                return {code, std::uint8_t(sizeof(type) * 8), 1};
+            }
+
+            inline bool operator==(DLDataType const &lhs, DLDataType const &rhs) {
+                return lhs.code == rhs.code && lhs.bits == rhs.bits && lhs.lanes == rhs.lanes;
+            }
+
+            template <class Traits, std::enable_if_t<storage::traits::is_host_referenceable<Traits>, int> = 0>
+            DLDevice make_device() {
+                return {kDLCPU, 0};
+            }
+
+#ifdef GT_CUDACC
+            template <class Traits, std::enable_if_t<!storage::traits::is_host_referenceable<Traits>, int> = 0>
+            DLDevice make_device() {
+                int device;
+                GT_CUDA_CHECK(cudaGetDevice(&device));
+#ifdef __HIP__
+                return {kDLROCM, device};
+#else
+                return {kDLCUDA, device};
+#endif
+            }
+#endif
+
+            template <class DataStore, class Managed>
+            struct export_ctx {
+                std::shared_ptr<DataStore> m_ds;
+                std::array<std::int64_t, DataStore::ndims> m_shape;
+                std::array<std::int64_t, DataStore::ndims> m_strides;
+                Managed m_tensor;
+
+                static void deleter(Managed *self) { delete static_cast<export_ctx *>(self->manager_ctx); }
+            };
+
+            template <class Traits, class T, class Info, class Kind>
+            DLDevice device_of(std::shared_ptr<storage::data_store_impl_::data_store<Traits, T, Info, Kind>> const &) {
+                return make_device<Traits>();
+            }
+
+            template <class Managed, class DataStorePtr>
+            Managed *export_tensor(DataStorePtr const &ds) {
+                static_assert(storage::is_data_store_ptr<DataStorePtr>::value);
+                using data_store_t = typename DataStorePtr::element_type;
+                using data_t = typename data_store_t::data_t;
+                auto ctx = std::make_unique<export_ctx<data_store_t, Managed>>();
+                ctx->m_ds = ds;
+                auto &&lengths = ds->lengths();
+                auto &&strides = ds->strides();
+                for (size_t i = 0; i != data_store_t::ndims; ++i) {
+                    ctx->m_shape[i] = lengths[i];
+                    ctx->m_strides[i] = strides[i];
+                }
+                auto &tensor = ctx->m_tensor.dl_tensor;
+                // const data stores are exported read-only, the others are synchronized for a write on the target
+                if constexpr (std::is_const_v<data_t>)
+                    tensor.data = const_cast<std::remove_const_t<data_t> *>(ds->get_const_target_ptr());
+                else
+                    tensor.data = ds->get_target_ptr();
+                tensor.device = device_of(ds);
+                tensor.ndim = data_store_t::ndims;
+                tensor.dtype = make_dtype<data_t>();
+                tensor.shape = ctx->m_shape.data();
+                tensor.strides = ctx->m_strides.data();
+                tensor.byte_offset = 0;
+                ctx->m_tensor.manager_ctx = ctx.get();
+                ctx->m_tensor.deleter = &export_ctx<data_store_t, Managed>::deleter;
+                return &ctx.release()->m_tensor;
+            }
+
+            template <class DataStorePtr>
+            DLManagedTensor *to_dlpack(DataStorePtr const &ds) {
+                static_assert(!std::is_const_v<typename DataStorePtr::element_type::data_t>,
+                    "DLPack 0.8 tensors are writable, use to_dlpack_versioned to export a const data store");
+                return export_tensor<DLManagedTensor>(ds);
+            }
+
+            template <class DataStorePtr>
+            DLManagedTensorVersioned *to_dlpack_versioned(DataStorePtr const &ds) {
+                auto *res = export_tensor<DLManagedTensorVersioned>(ds);
+                res->version = {1, 0};
+                res->flags = std::is_const_v<typename DataStorePtr::element_type::data_t>
+                                 ? DLPACK_FLAG_BITMASK_READ_ONLY
+                                 : 0;
+                return res;
+            }
+
+            struct tensor_deleter {
+                template <class Managed>
+                void operator()(Managed *tensor) const {
+                    if (tensor && tensor->deleter)
+                        tensor->deleter(tensor);
+                }
+            };
+
+            template <size_t, class>
+            struct kind {};
+
+            template <class T, size_t Dim, class Kind>
+            struct wrapper {
+                // aliases the managed tensor, which owns it
+                std::shared_ptr<DLTensor const> m_tensor;
+
+                DLTensor const &tensor() const { return *m_tensor; }
+
+                friend sid::host_device::simple_ptr_holder<T *> sid_get_origin(wrapper const &obj) {
+                    auto &t = obj.tensor();
+                    return {reinterpret_cast<T *>(static_cast<char *>(t.data) + t.byte_offset)};
+                }
+                friend std::array<std::int64_t, Dim> sid_get_strides(wrapper const &obj) {
+                    auto &t = obj.tensor();
+                    std::array<std::int64_t, Dim> res;
+                    if (t.strides) {
+                        for (size_t i = 0; i != Dim; ++i)
+                            res[i] = t.strides[i];
+                    } else {
+                        std::int64_t s = 1;
+                        for (size_t i = Dim; i != 0; --i) {
+                            res[i - 1] = s;
+                            s *= t.shape[i - 1];
+                        }
+                    }
+                    return res;
+                }
+                friend std::array<integral_constant<std::int64_t, 0>, Dim> sid_get_lower_bounds(wrapper const &) {
+                    return {};
+                }
+                friend std::array<std::int64_t, Dim> sid_get_upper_bounds(wrapper const &obj) {
+                    std::array<std::int64_t, Dim> res;
+                    for (size_t i = 0; i != Dim; ++i)
+                        res[i] = obj.tensor().shape[i];
+                    return res;
+                }
+                friend meta::if_<std::is_same<Kind, sid::unknown_kind>, Kind, kind<Dim, Kind>> sid_get_strides_kind(
+                    wrapper const &) {
+                    return {};
+                }
+
+                // the device the data lives on, to be checked against the backend by the caller
+                DLDevice device() const { return tensor().device; }
+            };
+
+            template <class T, size_t Dim, class Kind, class Managed, class Deleter>
+            wrapper<T, Dim, Kind> make_wrapper(Managed *src, Deleter deleter, bool read_only) {
+                std::shared_ptr<Managed> managed(src, std::move(deleter));
+                if (!src)
+                    throw std::invalid_argument("null DLPack tensor");
+                auto &t = src->dl_tensor;
+                if (t.ndim != Dim)
+                    throw std::domain_error("DLPack tensor has incorrect number of dimensions: " +
+                                            std::to_string(t.ndim) + "; expected " + std::to_string(Dim));
+                if (!(t.dtype == make_dtype<T>()))
+                    throw std::domain_error("DLPack tensor has incorrect dtype (code " + std::to_string(t.dtype.code) +
+                                            ", bits " + std::to_string(t.dtype.bits) + ", lanes " +
+                                            std::to_string(t.dtype.lanes) + ")");
+                if (t.byte_offset % sizeof(T))
+                    throw std::domain_error("DLPack tensor byte offset is not a multiple of the item size");
+                if (read_only && !std::is_const_v<T>)
+                    throw std::domain_error("DLPack tensor is read-only; a const element type is required");
+                return {std::shared_ptr<DLTensor const>(managed, &t)};
+            }
+
+            template <class T, size_t Dim, class Kind = void, class Deleter = tensor_deleter>
+            wrapper<T, Dim, Kind> as_sid(DLManagedTensor *src, Deleter deleter = {}) {
+                return make_wrapper<T, Dim, Kind>(src, std::move(deleter), false);
+            }
+
+            template <class T, size_t Dim, class Kind = void, class Deleter = tensor_deleter>
+            wrapper<T, Dim, Kind> as_sid(DLManagedTensorVersioned *src, Deleter deleter = {}) {
+                if (src && src->version.major != 1)
+                    throw std::domain_error(
+                        "unsupported DLPack major version: " + std::to_string(src->version.major));
+                return make_wrapper<T, Dim, Kind>(
+                    src, std::move(deleter), src && (src->flags & DLPACK_FLAG_BITMASK_READ_ONLY));
+            }
+        } // namespace dlpack_impl_
+
+        // Exports a data store as a `DLManagedTensor`; the caller (or the consumer) must call its deleter.
+        using dlpack_impl_::to_dlpack;
+
+        // Exports a data store as a `DLManagedTensorVersioned`, read-only if the elements are const.
+        using dlpack_impl_::to_dlpack_versioned;
+
+        // Makes a SID from a `DLManagedTensor` or a `DLManagedTensorVersioned`, taking the ownership. A custom deleter
+        // can be passed, by default the deleter of the tensor is called.
+        using dlpack_impl_::as_sid;
+    } // namespace dlpack
+} // namespace gridtools
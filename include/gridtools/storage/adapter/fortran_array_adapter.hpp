@@ -9,12 +9,15 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
 
 #include <cpp_bindgen/fortran_array_view.hpp>
 
 #include "../../layout_transformation.hpp"
+#include "../../sid/synthetic.hpp"
 #include "../data_store.hpp"
+#include "../sid.hpp"
 
 namespace gridtools {
     template <class DataStorePtr>
@@ -59,6 +62,19 @@ namespace gridtools {
             return res;
         }
 
+        template <class Ptr>
+        auto make_sid(DataStorePtr const &ds, Ptr ptr) const {
+            using namespace sid;
+            using ptr_holder_t = storage::storage_sid_impl_::ptr_holder<std::remove_pointer_t<Ptr>>;
+            return synthetic()
+                .template set<property::origin>(ptr_holder_t{ptr})
+                .template set<property::strides>(ds->native_strides())
+                .template set<property::strides_kind, typename data_store_t::kind_t>()
+                .template set<property::ptr_diff, int_t>()
+                .template set<property::lower_bounds>(storage::sid_get_lower_bounds(ds))
+                .template set<property::upper_bounds>(storage::sid_get_upper_bounds(ds));
+        }
+
       public:
         fortran_array_adapter(const bindgen_fortran_array_descriptor &descriptor) : m_descriptor(descriptor) {
             if (m_descriptor.rank != bindgen_view_rank::value)
@@ -81,5 +97,42 @@ namespace gridtools {
             transform_layout(
                 fortran_ptr(), src->get_target_ptr(), src->lengths(), fortran_strides(src), src->strides());
         }
+
+        // True if the fortran array has the strides of `ds` and an address aligned like its data, such that it can be
+        // used in place of `ds` without a copy.
+        bool is_layout_compatible(DataStorePtr const &ds) const {
+            check_fortran_lengths(ds);
+            constexpr auto alignment = storage::traits::byte_alignment<typename data_store_t::traits_t>;
+            // the data store aligns its first interior element, not the beginning of the allocation: with the same
+            // strides, the fortran array qualifies if it is misaligned by the same amount as the data store, whose
+            // address is inspected without synchronizing it
+            auto misalignment = [&](void const *ptr) { return reinterpret_cast<std::uintptr_t>(ptr) % alignment; };
+            if (misalignment(m_descriptor.data) != misalignment(ds->target_address()))
+                return false;
+            auto &&strides = ds->strides();
+            auto &&expected = fortran_strides(ds);
+            for (size_t i = 0; i < expected.size(); ++i)
+                if (strides[i] != expected[i])
+                    return false;
+            return true;
+        }
+
+        /**
+         * Makes a SID with the strides, strides kind and bounds of `ds`. If the layouts are compatible, the SID refers
+         * to the fortran memory directly and `ds` is not touched. Otherwise the fortran array is copied into `ds` and
+         * the SID refers to `ds`; in this case `sync_from_sid` must be called to copy the results back.
+         */
+        auto as_sid(DataStorePtr const &ds) const {
+            if (is_layout_compatible(ds))
+                return make_sid(ds, fortran_ptr());
+            transform_to(ds);
+            return make_sid(ds, ds->get_target_ptr());
+        }
+
+        // Copies `ds` back to the fortran array after a computation on `as_sid(ds)`, if `as_sid` had to copy.
+        void sync_from_sid(DataStorePtr const &ds) const {
+            if (!is_layout_compatible(ds))
+                transform_from(ds);
+        }
     };
 } // namespace gridtools
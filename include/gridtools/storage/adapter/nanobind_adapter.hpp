@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
@@ -21,6 +22,7 @@
 #include "../../sid/simple_ptr_holder.hpp"
 #include "../../sid/synthetic.hpp"
 #include "../../sid/unknown_kind.hpp"
+#include "dlpack.hpp"
 
 namespace gridtools {
     namespace nanobind_sid_adapter_impl_ {
@@ -89,9 +91,42 @@ namespace gridtools {
                 .template set<property::lower_bounds>(gridtools::array<integral_constant<std::size_t, 0>, ndim>())
                 .template set<property::upper_bounds>(shape);
         }
+
+        // Exports a data store as a `nanobind::ndarray` sharing its memory. The data store is kept alive by the array.
+        // A data store of const elements is exported through a read-only DLPack 1.0 tensor as a read-only
+        // `nanobind::ndarray<T const>`. Importing DLPack tensors is supported by `nanobind::ndarray` itself, see
+        // `as_sid` above.
+        template <class DataStorePtr>
+        auto as_ndarray(DataStorePtr const &ds) {
+            using data_t = typename DataStorePtr::element_type::data_t;
+            using value_t = std::remove_const_t<data_t>;
+            auto *tensor = [&] {
+                if constexpr (std::is_const_v<data_t>)
+                    return dlpack::to_dlpack_versioned(ds);
+                else
+                    return dlpack::to_dlpack(ds);
+            }();
+            using managed_t = std::remove_pointer_t<decltype(tensor)>;
+            auto const &t = tensor->dl_tensor;
+            ::nanobind::capsule owner(tensor, [](void *ptr) noexcept {
+                auto *tensor = static_cast<managed_t *>(ptr);
+                tensor->deleter(tensor);
+            });
+            gridtools::array<std::size_t, DataStorePtr::element_type::ndims> shape;
+            std::copy_n(t.shape, t.ndim, shape.begin());
+            return ::nanobind::ndarray<data_t>(t.data,
+                t.ndim,
+                shape.data(),
+                owner,
+                t.strides,
+                ::nanobind::dtype<value_t>(),
+                t.device.device_type,
+                t.device.device_id);
+        }
     } // namespace nanobind_sid_adapter_impl_
 
     namespace nanobind {
+        using nanobind_sid_adapter_impl_::as_ndarray;
         using nanobind_sid_adapter_impl_::as_sid;
         using nanobind_sid_adapter_impl_::fully_dynamic_strides;
         using nanobind_sid_adapter_impl_::stride_spec;
@@ -0,0 +1,127 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+#include "../../common/async_worker.hpp"
+#include "python_sid_adapter.hpp"
+
+/**
+ *  Running GridTools computations from Python without holding the GIL
+ *  ------------------------------------------------------------------
+ *
+ *  The SIDs made by `as_sid` and `as_dlpack_sid` pin the Python buffers they refer to and acquire the GIL only when
+ *  the last copy is destroyed. Therefore the computation itself can run with the GIL released:
+ *
+ *    - `call_without_gil(f, sids...)` calls `f(sids...)` synchronously with the GIL released;
+ *    - `async_call(f, sids...)` queues `f(sids...)` on a worker thread and immediately returns an `async_handle`.
+ *      `async_handle::wait()` releases the GIL while waiting and rethrows the exception thrown by `f`, if any.
+ *
+ *  The asynchronous calls run one after the other on a single worker thread, which is started by the first call. The
+ *  worker is shut down by an `atexit` hook of the interpreter: the pending calls are completed and the thread is
+ *  joined before the interpreter is finalized, hence the arguments are never released (which requires the GIL)
+ *  after `Py_Finalize`, even if the handles have been dropped. `async_call` throws after the shutdown.
+ *
+ *  Both must be called with the GIL held. `bind_async_handle(module)` exports `async_handle` to Python as
+ *  `AsyncHandle` with the methods `wait()` and `done()`.
+ *
+ *  Example:
+ *
+ *    m.def("copy_async", [](py::buffer from, py::buffer to) {
+ *        return async_call(&copy, as_sid<double const, 3>(from), as_sid<double, 3>(to));
+ *    });
+ *
+ *  Note that the caller is responsible for not modifying the buffers from Python while the computation is running.
+ */
+
+namespace gridtools {
+    namespace python_sid_adapter_impl_ {
+        class async_handle {
+            std::shared_future<void> m_future;
+
+          public:
+            async_handle(std::shared_future<void> future) : m_future(std::move(future)) {}
+
+            bool done() const { return m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+            void wait() const {
+                {
+                    pybind11::gil_scoped_release release;
+                    m_future.wait();
+                }
+                m_future.get();
+            }
+        };
+
+        template <class F, class... Args>
+        decltype(auto) call_without_gil(F &&f, Args &&...args) {
+            pybind11::gil_scoped_release release;
+            return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+        }
+
+        // created by the first call (with the GIL held) and never destroyed; shut down by the interpreter at exit
+        inline async_worker &python_async_worker() {
+            static async_worker *worker = [] {
+                auto *res = new async_worker();
+                pybind11::module_::import("atexit").attr("register")(pybind11::cpp_function([res] {
+                    // the pending calls may need the GIL to release their arguments
+                    pybind11::gil_scoped_release release;
+                    res->shutdown();
+                }));
+                return res;
+            }();
+            return *worker;
+        }
+
+        template <class F, class... Args>
+        async_handle async_call(F f, Args... args) {
+            // The promise is fulfilled only after the arguments have been destroyed (which may require the GIL). In
+            // contrast to `std::async`, destroying a handle never blocks, hence no deadlock on the GIL is possible.
+            auto promise = std::make_shared<std::promise<void>>();
+            std::shared_future<void> future = promise->get_future().share();
+            auto task = std::make_shared<std::unique_ptr<std::tuple<F, Args...>>>(
+                std::make_unique<std::tuple<F, Args...>>(std::move(f), std::move(args)...));
+            python_async_worker().submit([promise, task] {
+                std::exception_ptr error;
+                try {
+                    std::apply([](auto &f, auto &...args) { std::invoke(f, args...); }, **task);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                task->reset();
+                if (error)
+                    promise->set_exception(error);
+                else
+                    promise->set_value();
+            });
+            return {std::move(future)};
+        }
+
+        inline void bind_async_handle(pybind11::module_ &m) {
+            pybind11::class_<async_handle>(m, "AsyncHandle")
+                .def("wait", &async_handle::wait, "Waits for the completion, rethrows the error if any.")
+                .def("done", &async_handle::done, "Checks whether the computation has completed.");
+        }
+    } // namespace python_sid_adapter_impl_
+
+    using python_sid_adapter_impl_::async_call;
+    using python_sid_adapter_impl_::async_handle;
+    using python_sid_adapter_impl_::bind_async_handle;
+    using python_sid_adapter_impl_::call_without_gil;
+} // namespace gridtools
@@ -17,6 +17,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -31,6 +32,7 @@
 #include "../../sid/simple_ptr_holder.hpp"
 #include "../../sid/synthetic.hpp"
 #include "../../sid/unknown_kind.hpp"
+#include "dlpack.hpp"
 
 namespace gridtools {
     namespace python_sid_adapter_impl_ {
@@ -110,6 +112,20 @@ namespace gridtools {
             }
         };
 
+        // Releasing a buffer requires the GIL. Holding it here allows SIDs to be copied and destroyed while the GIL is
+        // released, e.g. during a stencil run or on another thread.
+        struct gil_safe_delete_f {
+            template <class T>
+            void operator()(T *ptr) const {
+                pybind11::gil_scoped_acquire acquire;
+                delete ptr;
+            }
+        };
+
+        inline std::shared_ptr<pybind11::buffer_info> make_buffer_info_ptr(pybind11::buffer_info info) {
+            return {new pybind11::buffer_info(std::move(info)), gil_safe_delete_f()};
+        }
+
         template <class T, std::size_t Dim, class Kind = void, size_t UnitStrideDim = size_t(-1)>
         wrapper<T, Dim, Kind, UnitStrideDim> as_sid(pybind11::buffer const &src) {
             static_assert(std::is_trivially_copy_constructible_v<T>,
@@ -142,7 +158,7 @@ namespace gridtools {
                 throw std::domain_error(
                     "buffer has incorrect format: " + info.format + "; expected " + expected_format);
             }
-            return {std::make_shared<pybind11::buffer_info>(std::move(info))};
+            return {make_buffer_info_ptr(std::move(info))};
         }
 
         struct typestr {
@@ -351,10 +367,54 @@ namespace gridtools {
                 .template set<property::lower_bounds>(array<integral_constant<size_t, 0>, Dim>())
                 .template set<property::upper_bounds>(shape);
         }
+
+        inline void dltensor_capsule_destructor(PyObject *obj) {
+            // a consumer renames the capsule to "used_dltensor" and becomes responsible for calling the deleter
+            if (!PyCapsule_IsValid(obj, "dltensor"))
+                return;
+            auto *tensor = static_cast<dlpack::DLManagedTensor *>(PyCapsule_GetPointer(obj, "dltensor"));
+            if (tensor->deleter)
+                tensor->deleter(tensor);
+        }
+
+        // Makes a SID from any Python object that implements `__dlpack__` (NumPy, CuPy, PyTorch, ...) without a copy.
+        // The producer's tensor is kept alive by the SID.
+        template <class T, size_t Dim, class Kind = void>
+        auto as_dlpack_sid(pybind11::object const &src) {
+            auto capsule = src.attr("__dlpack__")().cast<pybind11::capsule>();
+            if (!PyCapsule_IsValid(capsule.ptr(), "dltensor"))
+                throw std::domain_error("__dlpack__ returned an invalid or already consumed capsule");
+            auto *tensor = static_cast<dlpack::DLManagedTensor *>(PyCapsule_GetPointer(capsule.ptr(), "dltensor"));
+            if (PyCapsule_SetName(capsule.ptr(), "used_dltensor"))
+                throw pybind11::error_already_set();
+            return dlpack::as_sid<T, Dim, Kind>(tensor, [](dlpack::DLManagedTensor *tensor) {
+                if (tensor && tensor->deleter) {
+                    pybind11::gil_scoped_acquire acquire;
+                    tensor->deleter(tensor);
+                }
+            });
+        }
+
+        // Exports a data store as a "dltensor" capsule, to be returned from a `__dlpack__` method.
+        template <class DataStorePtr>
+        pybind11::capsule to_dlpack_capsule(DataStorePtr const &ds) {
+            return pybind11::capsule(dlpack::to_dlpack(ds), "dltensor", &dltensor_capsule_destructor);
+        }
+
+        // The result of a `__dlpack_device__` method for the given data store.
+        template <class DataStorePtr>
+        std::tuple<int, int> dlpack_device(DataStorePtr const &ds) {
+            auto device = dlpack::dlpack_impl_::device_of(ds);
+            return {device.device_type, device.device_id};
+        }
     } // namespace python_sid_adapter_impl_
 
     // Makes a SID from the `pybind11::buffer`.
     using python_sid_adapter_impl_::as_sid;
 
     using python_sid_adapter_impl_::as_cuda_sid;
+
+    using python_sid_adapter_impl_::as_dlpack_sid;
+    using python_sid_adapter_impl_::dlpack_device;
+    using python_sid_adapter_impl_::to_dlpack_capsule;
 } // namespace gridtools
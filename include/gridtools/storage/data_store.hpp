@@ -9,11 +9,14 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../common/array.hpp"
 #include "../common/array_addons.hpp"
@@ -46,6 +49,7 @@ namespace gridtools {
                 mutable_data_t *m_target_ptr;
 
               public:
+                using traits_t = Traits;
                 using layout_t = traits::layout_type<Traits, Info::ndims>;
                 using data_t = T;
                 using kind_t = Kind;
@@ -59,6 +63,9 @@ namespace gridtools {
                 decltype(auto) strides() const { return m_info.strides(); }
                 decltype(auto) length() const { return m_info.length(); }
 
+                // the address of the target data, for inspection only: the data is not synchronized
+                void const *target_address() const { return m_target_ptr; }
+
               protected:
                 template <class Halos>
                 base(std::string name, Info info, Halos const &halos)
@@ -82,68 +89,132 @@ namespace gridtools {
                 bool = traits::is_host_referenceable<Traits>>
             class data_store;
 
+            /**
+             * Synchronization state is tracked per slab of the outermost dimension of the layout (k for the usual
+             * target layouts). Host or target access can be restricted to a range of slabs [begin, end), in which case
+             * only those slabs are synchronized and marked as modified.
+             */
             template <class Traits, class T, class Info, class Kind>
             class data_store<Traits, T, Info, Kind, false, false> : public base<Traits, T, Info, Kind> {
                 enum state { synced, invalid_host, invalid_target };
-                state m_state;
+                std::vector<state> m_states;
                 std::unique_ptr<T[]> m_host_ptr;
 
-                void update_target() {
-                    if (m_state != invalid_target)
-                        return;
-                    traits::update_target<Traits>(this->raw_target_ptr(), m_host_ptr.get(), this->info().length());
-                    m_state = synced;
+                using base_t = base<Traits, T, Info, Kind>;
+
+                static constexpr int outer_dim =
+                    base_t::layout_t::unmasked_length ? base_t::layout_t::find(0) : -1;
+
+                size_t num_slabs() const {
+                    if constexpr (outer_dim < 0)
+                        return 1;
+                    else
+                        return this->lengths()[outer_dim];
+                }
+
+                size_t slab_size() const {
+                    if constexpr (outer_dim < 0)
+                        return this->length();
+                    else
+                        return this->strides()[outer_dim];
+                }
+
+                template <class F>
+                void sync(state invalid, size_t begin, size_t end, F &&copy) {
+                    assert(begin <= end && end <= m_states.size());
+                    size_t length = this->length();
+                    size_t size = slab_size();
+                    // copy contiguous runs of invalid slabs at once
+                    for (size_t first = begin; first != end;) {
+                        if (m_states[first] != invalid) {
+                            ++first;
+                            continue;
+                        }
+                        size_t last = first;
+                        for (; last != end && m_states[last] == invalid; ++last)
+                            m_states[last] = synced;
+                        size_t offset = first * size;
+                        copy(offset, std::min(last * size, length) - offset);
+                        first = last;
+                    }
+                }
+
+                void update_target(size_t begin, size_t end) {
+                    sync(invalid_target, begin, end, [&](size_t offset, size_t count) {
+                        traits::update_target<Traits>(this->raw_target_ptr() + offset, m_host_ptr.get() + offset, count);
+                    });
                 }
 
-                void update_host() {
-                    if (m_state != invalid_host)
-                        return;
-                    traits::update_host<Traits>(m_host_ptr.get(), this->raw_target_ptr(), this->info().length());
-                    m_state = synced;
+                void update_host(size_t begin, size_t end) {
+                    sync(invalid_host, begin, end, [&](size_t offset, size_t count) {
+                        traits::update_host<Traits>(m_host_ptr.get() + offset, this->raw_target_ptr() + offset, count);
+                    });
+                }
+
+                void invalidate(state invalid, size_t begin, size_t end) {
+                    assert(begin <= end && end <= m_states.size());
+                    std::fill(m_states.begin() + begin, m_states.begin() + end, invalid);
                 }
 
               public:
                 template <class Halos>
                 data_store(std::string name, Info info, Halos const &halos, uninitialized const &)
-                    : data_store::base(std::move(name), std::move(info), halos), m_state(synced),
+                    : data_store::base(std::move(name), std::move(info), halos), m_states(num_slabs(), synced),
                       m_host_ptr(std::make_unique<T[]>(this->info().length())) {}
 
                 template <class Initializer, class Halos>
                 data_store(std::string name, Info info, Halos const &halos, Initializer const &initializer)
-                    : data_store::base(std::move(name), std::move(info), halos), m_state(invalid_target),
+                    : data_store::base(std::move(name), std::move(info), halos), m_states(num_slabs(), invalid_target),
                       m_host_ptr(std::make_unique<T[]>(this->info().length())) {
                     initializer(m_host_ptr.get(), typename data_store::layout_t(), this->info());
                 }
 
-                T *get_target_ptr() {
-                    update_target();
-                    m_state = invalid_host;
+                T *get_target_ptr(size_t begin, size_t end) {
+                    update_target(begin, end);
+                    invalidate(invalid_host, begin, end);
                     return this->raw_target_ptr();
                 }
 
-                T const *get_const_target_ptr() {
-                    update_target();
+                T const *get_const_target_ptr(size_t begin, size_t end) {
+                    update_target(begin, end);
                     return this->raw_target_ptr();
                 }
 
-                T *get_host_ptr() {
-                    update_host();
-                    m_state = invalid_target;
+                T *get_host_ptr(size_t begin, size_t end) {
+                    update_host(begin, end);
+                    invalidate(invalid_target, begin, end);
                     return m_host_ptr.get();
                 }
 
-                T const *get_const_host_ptr() {
-                    update_host();
+                T const *get_const_host_ptr(size_t begin, size_t end) {
+                    update_host(begin, end);
                     return m_host_ptr.get();
                 }
 
+                T *get_target_ptr() { return get_target_ptr(0, m_states.size()); }
+                T const *get_const_target_ptr() { return get_const_target_ptr(0, m_states.size()); }
+                T *get_host_ptr() { return get_host_ptr(0, m_states.size()); }
+                T const *get_const_host_ptr() { return get_const_host_ptr(0, m_states.size()); }
+
                 auto host_view() { return make_host_view(get_host_ptr(), this->info()); }
                 auto const_host_view() { return make_host_view(get_const_host_ptr(), this->info()); }
+                auto host_view(size_t begin, size_t end) {
+                    return make_host_view(get_host_ptr(begin, end), this->info());
+                }
+                auto const_host_view(size_t begin, size_t end) {
+                    return make_host_view(get_const_host_ptr(begin, end), this->info());
+                }
 
                 auto target_view() { return traits::make_target_view<Traits>(get_target_ptr(), this->info()); }
                 auto const_target_view() {
                     return traits::make_target_view<Traits>(get_const_target_ptr(), this->info());
                 }
+                auto target_view(size_t begin, size_t end) {
+                    return traits::make_target_view<Traits>(get_target_ptr(begin, end), this->info());
+                }
+                auto const_target_view(size_t begin, size_t end) {
+                    return traits::make_target_view<Traits>(get_const_target_ptr(begin, end), this->info());
+                }
             };
 
             template <class Traits, class T, class Info, class Kind>
@@ -171,6 +242,16 @@ namespace gridtools {
                 T const *get_const_host_ptr() { return get_const_target_ptr(); }
                 auto host_view() const { return target_view(); }
                 auto const_host_view() const { return const_target_view(); }
+
+                // host and target are the same, the slab ranges are ignored
+                T *get_target_ptr(size_t, size_t) const { return get_target_ptr(); }
+                T const *get_const_target_ptr(size_t, size_t) const { return get_const_target_ptr(); }
+                T *get_host_ptr(size_t, size_t) { return get_host_ptr(); }
+                T const *get_const_host_ptr(size_t, size_t) { return get_const_host_ptr(); }
+                auto target_view(size_t, size_t) const { return target_view(); }
+                auto const_target_view(size_t, size_t) const { return const_target_view(); }
+                auto host_view(size_t, size_t) const { return host_view(); }
+                auto const_host_view(size_t, size_t) const { return const_host_view(); }
             };
 
             template <class Traits, class T, class Info, class Kind, bool IsHostRefrenceable>
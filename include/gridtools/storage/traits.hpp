@@ -12,6 +12,7 @@
 #include <numeric>
 #include <type_traits>
 
+#include "../common/memory_pool.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/unknown_kind.hpp"
@@ -79,9 +80,17 @@ namespace gridtools {
                 return tuple_util::get<Layout::find(Dims - 1)>(lengths) % Alignment;
             }
 
+            template <class Traits, class T>
+            struct allocate_f {
+                auto operator()(size_t size) const { return storage_allocate(Traits(), meta::lazy::id<T>(), size); }
+            };
+
+            /**
+             * Allocates `size` elements through the process-wide memory pool of the given storage traits.
+             */
             template <class Traits, class T>
             auto allocate(size_t size) {
-                return storage_allocate(Traits(), meta::lazy::id<T>(), size);
+                return memory_pool_allocate(allocate_f<Traits, T>(), size);
             }
 
             template <class Traits, class T>
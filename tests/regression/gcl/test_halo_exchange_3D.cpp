@@ -9,6 +9,7 @@
  */
 #include <gridtools/gcl/halo_exchange.hpp>
 
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -38,6 +39,13 @@ struct test_spec {
     int dims[num_dims];
     int halos[num_fields][num_dims][num_halos];
     int mpi_dims[num_dims];
+    bool persistent_requests = false;
+    bool shared_memory = false;
+    bool neighborhood_collectives = false;
+    bool derived_datatypes = false;
+    bool progress_thread = false;
+    bool compression = false;
+    bool pipelined = false;
 };
 
 using value_type = array<int, num_dims + 1>;
@@ -59,10 +67,21 @@ void exchange(std::true_type, Testee &testee, Fields const &...fields) {
     testee.unpack(vec);
 }
 
+template <class Testee, class... Fields>
+void exchange_pipelined(std::false_type, Testee &testee, Fields const &...fields) {
+    testee.exchange_pipelined(fields...);
+}
+
+template <class Testee, class... Fields>
+void exchange_pipelined(std::true_type, Testee &testee, Fields const &...fields) {
+    testee.exchange_pipelined(std::vector<std::common_type_t<Fields...>>{fields...});
+}
+
 class halo_exchange_3D_test : public testing::TestWithParam<test_spec> {
     int mpi_dims[num_dims];
     int coords[num_dims] = {};
 
+  protected:
     value_type initial_state(int i, int j, int k, int field_no) const {
         auto val = [&](int i, int d) {
             auto size = GetParam().dims[d];
@@ -207,6 +226,269 @@ INSTANTIATE_TEST_SUITE_P(tests,
             .halos = {{{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}},
             .mpi_dims = {2, 1}}));
 
+struct halo_exchange_3D_transport : halo_exchange_3D_test {};
+
+TEST_P(halo_exchange_3D_transport, test) {
+    auto &&spec = GetParam();
+    if ((spec.derived_datatypes || spec.progress_thread || spec.compression || spec.pipelined) &&
+        !std::is_same_v<gcl_arch_t, gcl::cpu>)
+        GTEST_SKIP() << "the transport is available for the cpu architecture only";
+    run_exchanges([&](auto layout, auto use_vector_interface, auto &&storages, auto... periodicity) {
+        using testee_t = gcl::halo_exchange_dynamic_ut<decltype(layout), layout_map<0, 1, 2>, value_type, gcl_arch_t>;
+        testee_t testee({periodicity...}, CartComm);
+        auto halo_descriptors = make_halo_descriptors(storages, 0);
+        for_each<meta::make_indices_c<num_fields>>(
+            [&](auto f) { testee.template add_halo<decltype(f)::value>(halo_descriptors[f.value]); });
+        // all the processes of the test run on the same node
+        testee.use_shared_memory(GetParam().shared_memory);
+        testee.setup(3, GetParam().persistent_requests);
+        testee.use_neighborhood_collectives(GetParam().neighborhood_collectives);
+        if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>) {
+            testee.use_derived_datatypes(GetParam().derived_datatypes);
+            testee.use_progress_thread(GetParam().progress_thread);
+            // the fields are compressed differently, the third one is not compressed
+            if (GetParam().compression)
+                testee.use_compression({gcl::halo_compression(), gcl::halo_compression::lossless()});
+        }
+        EXPECT_EQ(testee.pattern().uses_persistent_requests(), GetParam().persistent_requests);
+        EXPECT_EQ(testee.pattern().has_shared_send_buffers(), GetParam().shared_memory);
+        EXPECT_EQ(testee.pattern().uses_neighborhood_collectives(), GetParam().neighborhood_collectives);
+        auto field = [&](int f) { return storages[f]->get_target_ptr(); };
+        // the buffers and the requests are set up for 3 fields, the second exchange has shorter messages
+        if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>) {
+            if (GetParam().pipelined) {
+                exchange_pipelined(use_vector_interface, testee, field(0), field(1), field(2));
+                exchange_pipelined(use_vector_interface, testee, field(0), field(1));
+                exchange_pipelined(use_vector_interface, testee, field(0), field(1), field(2));
+            } else {
+                exchange(use_vector_interface, testee, field(0), field(1), field(2));
+                exchange(use_vector_interface, testee, field(0), field(1));
+                exchange(use_vector_interface, testee, field(0), field(1), field(2));
+            }
+            if (GetParam().compression && !GetParam().shared_memory) {
+                EXPECT_GT(testee.compression_ratio(), 1);
+            }
+        } else {
+            exchange(use_vector_interface, testee, field(0), field(1), field(2));
+            exchange(use_vector_interface, testee, field(0), field(1));
+            exchange(use_vector_interface, testee, field(0), field(1), field(2));
+        }
+        if (GetParam().progress_thread)
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if (i || j || k) {
+                            EXPECT_EQ(testee.pattern().received(i, j, k),
+                                testee.pattern().proc_grid().proc(i, j, k) != -1)
+                                << i << ", " << j << ", " << k;
+                        }
+    });
+}
+
+INSTANTIATE_TEST_SUITE_P(tests,
+    halo_exchange_3D_transport,
+    testing::Values(test_spec{.dims = {23, 12, 7},
+                        .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+                        .mpi_dims = {2, 1},
+                        .persistent_requests = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .shared_memory = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true,
+            .shared_memory = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .neighborhood_collectives = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .shared_memory = true,
+            .neighborhood_collectives = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .derived_datatypes = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true,
+            .derived_datatypes = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .neighborhood_collectives = true,
+            .derived_datatypes = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .progress_thread = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true,
+            .shared_memory = true,
+            .progress_thread = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .neighborhood_collectives = true,
+            .derived_datatypes = true,
+            .progress_thread = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .compression = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true,
+            .shared_memory = true,
+            .compression = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .progress_thread = true,
+            .compression = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .pipelined = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .persistent_requests = true,
+            .shared_memory = true,
+            .pipelined = true},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {},
+            .derived_datatypes = true,
+            .pipelined = true},
+        test_spec{.dims = {23, 12, 7},
+            .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+            .mpi_dims = {2, 1},
+            .persistent_requests = true,
+            .compression = true,
+            .pipelined = true}));
+
+struct halo_exchange_3D_benchmark : halo_exchange_3D_test {};
+
+// compares the exchanges through point-to-point messages, through a neighborhood collective, with derived datatypes
+// instead of packing, driven by a progress thread and pipelined
+TEST_P(halo_exchange_3D_benchmark, transports) {
+    constexpr int steps = 20;
+    using layout_t = layout_map<0, 1, 2>;
+    auto storages = make_storages(layout_t());
+    auto halo_descriptors = make_halo_descriptors(storages, 0);
+    auto field = [&](int f) { return storages[f]->get_target_ptr(); };
+    for (std::string transport :
+        {"point_to_point", "neighborhood_collective", "derived_datatypes", "progress_thread", "pipelined"}) {
+        bool datatypes = transport == "derived_datatypes";
+        bool progress = transport == "progress_thread";
+        bool pipelined = transport == "pipelined";
+        if ((datatypes || progress || pipelined) && !std::is_same_v<gcl_arch_t, gcl::cpu>)
+            continue;
+        using testee_t = gcl::halo_exchange_dynamic_ut<layout_t, layout_map<0, 1, 2>, value_type, gcl_arch_t>;
+        testee_t testee({true, true, true}, CartComm);
+        for_each<meta::make_indices_c<num_fields>>(
+            [&](auto f) { testee.template add_halo<decltype(f)::value>(halo_descriptors[f.value]); });
+        testee.setup(3);
+        testee.use_neighborhood_collectives(transport == "neighborhood_collective");
+        if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>) {
+            testee.use_derived_datatypes(datatypes);
+            testee.use_progress_thread(progress);
+        }
+        auto run = [&] {
+            if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>) {
+                if (pipelined) {
+                    testee.exchange_pipelined(field(0), field(1), field(2));
+                    return;
+                }
+            }
+            exchange(std::false_type(), testee, field(0), field(1), field(2));
+        };
+        run();
+        MPI_Barrier(CartComm);
+        double time = MPI_Wtime();
+        for (int step = 0; step != steps; ++step)
+            run();
+        time = (MPI_Wtime() - time) / steps;
+        MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, CartComm);
+        RecordProperty(transport + "_seconds", std::to_string(time));
+    }
+    verify(storages, {true, true, true});
+}
+
+INSTANTIATE_TEST_SUITE_P(tests,
+    halo_exchange_3D_benchmark,
+    testing::Values(test_spec{.dims = {48, 48, 48},
+        .halos = {{{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}},
+        .mpi_dims = {}}));
+
+struct halo_exchange_3D_slices : halo_exchange_3D_test {};
+
+// exchanges a 4D field, whose outermost dimension (e.g. the tracers) is aggregated into the messages
+TEST_P(halo_exchange_3D_slices, test) {
+    constexpr int slices = 4;
+    auto &&halos = GetParam().halos[0];
+    auto size = [&](int d) { return GetParam().dims[d] + halos[d][0] + halos[d][1]; };
+    auto in_halo = [&](int i, int d) {
+        i -= halos[d][0];
+        return i < 0 || i >= GetParam().dims[d];
+    };
+    auto state = [&](int i, int j, int k, int s) {
+        auto res = initial_state(i, j, k, 0);
+        res[3] = s;
+        return res;
+    };
+    auto storage = storage::builder<storage_traits_t>
+                       .type<value_type>()
+                       .layout<1, 2, 3, 0>()
+                       .dimensions(size(0), size(1), size(2), slices)
+                       .initializer([&](int i, int j, int k, int s) {
+                           return in_halo(i, 0) || in_halo(j, 1) || in_halo(k, 2) ? none() : state(i, j, k, s);
+                       })
+                       .build();
+    auto total_lengths = make_total_lengths(*storage);
+    using testee_t = gcl::halo_exchange_dynamic_ut<layout_map<0, 1, 2>, layout_map<0, 1, 2>, value_type, gcl_arch_t>;
+    testee_t testee({true, true, true}, CartComm);
+    for_each<meta::make_indices_c<num_dims>>([&](auto d) {
+        testee.template add_halo<decltype(d)::value>(
+            halos[d][0], halos[d][1], halos[d][0], GetParam().dims[d] + halos[d][0] - 1, total_lengths[d]);
+    });
+    testee.setup(slices);
+    std::vector<value_type *> fields = {storage->get_target_ptr()};
+    testee.pack(fields, slices, storage->strides()[3]);
+    testee.exchange();
+    testee.unpack(fields, slices, storage->strides()[3]);
+    EXPECT_EQ(testee.pattern().statistics(1, 0, 0).sent_messages, testee.pattern().proc_grid().proc(1, 0, 0) != -1);
+    auto view = storage->const_host_view();
+    for (int i = 0; i != size(0); ++i)
+        for (int j = 0; j != size(1); ++j)
+            for (int k = 0; k != size(2); ++k)
+                for (int s = 0; s != slices; ++s)
+                    EXPECT_EQ(view(i, j, k, s), state(i, j, k, s))
+                        << "pid:" << gcl::pid() << " i:" << i << " j:" << j << " k:" << k << " s:" << s;
+}
+
+INSTANTIATE_TEST_SUITE_P(tests,
+    halo_exchange_3D_slices,
+    testing::Values(test_spec{.dims = {23, 12, 7},
+                        .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+                        .mpi_dims = {2, 1}},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}, {{2, 3}, {1, 2}, {2, 1}}},
+            .mpi_dims = {}}));
+
 struct halo_exchange_3D_generic : halo_exchange_3D_test {
     array<halo_descriptor, num_dims> make_enclosed_halo_descriptor() {
         array<halo_descriptor, num_dims> res;
@@ -0,0 +1,113 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/gcl/heterogeneous_halo_exchange.hpp>
+
+#include <mpi.h>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/array.hpp>
+#include <gridtools/common/halo_descriptor.hpp>
+#include <gridtools/storage/builder.hpp>
+
+#include <gcl_select.hpp>
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        constexpr int dims[3] = {9, 7, 4};
+
+        struct heterogeneous_halo_exchange_test : testing::Test {
+            MPI_Comm comm;
+            int mpi_dims[3] = {};
+            int coords[3] = {};
+
+            heterogeneous_halo_exchange_test() {
+                MPI_Dims_create(gcl::procs(), 3, mpi_dims);
+                int period[3] = {1, 1, 1};
+                MPI_Cart_create(gcl::world(), 3, mpi_dims, period, false, &comm);
+                MPI_Cart_get(comm, 3, mpi_dims, period, coords);
+            }
+
+            ~heterogeneous_halo_exchange_test() { MPI_Comm_free(&comm); }
+
+            // the global index of the local index i, the domain being periodic
+            int global(int i, int d, int minus) const {
+                int n = dims[d] * mpi_dims[d];
+                return ((coords[d] * dims[d] + i - minus) % n + n) % n;
+            }
+
+            template <class T, int... Layout>
+            auto make_field(int const (&minus)[3], int const (&plus)[3]) const {
+                auto value = [=](int i, int j, int k) {
+                    bool in_halo = i < minus[0] || i >= minus[0] + dims[0] || j < minus[1] ||
+                                   j >= minus[1] + dims[1] || k < minus[2] || k >= minus[2] + dims[2];
+                    return in_halo ? T(-1) : expected<T>(i, j, k, minus);
+                };
+                return storage::builder<storage_traits_t>
+                    .template type<T>()
+                    .template layout<Layout...>()
+                    .dimensions(dims[0] + minus[0] + plus[0],
+                        dims[1] + minus[1] + plus[1],
+                        dims[2] + minus[2] + plus[2])
+                    .initializer(value)
+                    .build();
+            }
+
+            template <class T>
+            T expected(int i, int j, int k, int const (&minus)[3]) const {
+                return T(global(i, 0, minus[0]) * 10000 + global(j, 1, minus[1]) * 100 + global(k, 2, minus[2]));
+            }
+
+            static array<halo_descriptor, 3> make_halos(int const (&minus)[3], int const (&plus)[3]) {
+                array<halo_descriptor, 3> res;
+                for (int d = 0; d < 3; ++d)
+                    res[d] = halo_descriptor(
+                        minus[d], plus[d], minus[d], minus[d] + dims[d] - 1, minus[d] + dims[d] + plus[d]);
+                return res;
+            }
+
+            template <class T, class Field>
+            void verify(Field const &field, int const (&minus)[3]) const {
+                auto view = field->const_host_view();
+                auto &&lengths = view.lengths();
+                for (int i = 0; i < lengths[0]; ++i)
+                    for (int j = 0; j < lengths[1]; ++j)
+                        for (int k = 0; k < lengths[2]; ++k)
+                            EXPECT_EQ(view(i, j, k), expected<T>(i, j, k, minus))
+                                << "pid:" << gcl::pid() << " i:" << i << " j:" << j << " k:" << k;
+            }
+        };
+
+        TEST_F(heterogeneous_halo_exchange_test, mixed_fields) {
+            constexpr int minus_a[3] = {2, 2, 1}, plus_a[3] = {2, 2, 1};
+            constexpr int minus_b[3] = {1, 0, 0}, plus_b[3] = {1, 1, 0};
+            constexpr int minus_c[3] = {3, 1, 2}, plus_c[3] = {1, 2, 1};
+            auto a = make_field<double, 0, 1, 2>(minus_a, plus_a);
+            auto b = make_field<float, 2, 1, 0>(minus_b, plus_b);
+            auto c = make_field<int, 1, 0, 2>(minus_c, plus_c);
+
+            gcl::heterogeneous_halo_exchange testee({true, true, true}, comm);
+            testee.exchange(gcl::make_halo_field(a, make_halos(minus_a, plus_a)),
+                gcl::make_halo_field(b, make_halos(minus_b, plus_b)),
+                gcl::make_halo_field(c, make_halos(minus_c, plus_c)));
+            verify<double>(a, minus_a);
+            verify<float>(b, minus_b);
+            verify<int>(c, minus_c);
+
+            // the buffers grow when more fields are exchanged
+            auto d = make_field<double, 2, 0, 1>(minus_c, plus_c);
+            testee.exchange(gcl::make_halo_field(d, make_halos(minus_c, plus_c)),
+                gcl::make_halo_field(a, make_halos(minus_a, plus_a)),
+                gcl::make_halo_field(c, make_halos(minus_c, plus_c)));
+            verify<double>(d, minus_c);
+        }
+    } // namespace
+} // namespace gridtools
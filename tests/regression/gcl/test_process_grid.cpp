@@ -0,0 +1,86 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/gcl/low_level/proc_grids_3D.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <mpi.h>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/array.hpp>
+#include <gridtools/gcl/GCL.hpp>
+
+using namespace gridtools;
+using namespace gcl;
+
+TEST(process_grid, choose_dims) {
+    boollist<3> periodic(false, false, false);
+    // the dimensions without halos are split first
+    EXPECT_EQ(choose_process_grid(8, 1, {100, 100, 100}, {2, 2, 0}, periodic).dims, (array<int, 3>{1, 1, 8}));
+    // unless they are fixed
+    EXPECT_EQ(
+        choose_process_grid(8, 1, {100, 100, 100}, {2, 2, 0}, periodic, {0, 0, 1}).dims, (array<int, 3>{2, 4, 1}));
+    // the grid follows the aspect ratio of the domain
+    EXPECT_EQ(
+        choose_process_grid(16, 1, {200, 100, 10}, {2, 2, 0}, periodic, {0, 0, 1}).dims, (array<int, 3>{4, 4, 1}));
+    EXPECT_EQ(
+        choose_process_grid(16, 1, {400, 100, 10}, {2, 2, 0}, periodic, {0, 0, 1}).dims, (array<int, 3>{8, 2, 1}));
+    EXPECT_EQ(
+        choose_process_grid(16, 1, {1600, 100, 10}, {2, 2, 0}, periodic, {0, 0, 1}).dims, (array<int, 3>{16, 1, 1}));
+    EXPECT_THROW(choose_process_grid(8, 1, {100, 100, 100}, {2, 2, 0}, periodic, {3, 0, 1}), std::runtime_error);
+}
+
+TEST(process_grid, choose_node_blocks) {
+    boollist<3> periodic(true, true, false);
+    // 16 nodes of 4 processes: the nodes form a 4x4 grid of 2x2 blocks
+    auto grid = choose_process_grid(64, 4, {800, 800, 10}, {2, 2, 0}, periodic, {0, 0, 1});
+    EXPECT_EQ(grid.dims, (array<int, 3>{8, 8, 1}));
+    EXPECT_EQ(grid.node_dims, (array<int, 3>{2, 2, 1}));
+    // no block of 3 processes fits a grid of 4 processes
+    grid = choose_process_grid(4, 3, {800, 400, 10}, {2, 2, 0}, periodic, {0, 0, 1});
+    EXPECT_EQ(grid.dims, (array<int, 3>{4, 1, 1}));
+    EXPECT_EQ(grid.node_dims, (array<int, 3>{1, 1, 1}));
+}
+
+TEST(process_grid, make_communicator) {
+    array<int, 3> domain = {120, 60, 10};
+    MPI_Comm comm =
+        make_process_grid_communicator(MPI_COMM_WORLD, domain, {2, 2, 0}, {true, false, false}, {0, 0, 1}, false);
+    int topology;
+    MPI_Topo_test(comm, &topology);
+    ASSERT_EQ(topology, MPI_CART);
+
+    array<int, 3> dims, coords;
+    int periods[3];
+    MPI_Cart_get(comm, 3, &dims[0], periods, &coords[0]);
+    EXPECT_EQ(dims[0] * dims[1] * dims[2], procs());
+    EXPECT_EQ(dims[2], 1);
+    EXPECT_TRUE(periods[0]);
+    EXPECT_FALSE(periods[1]);
+
+    // the processes of a node form a block of the grid
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    int node_size;
+    MPI_Comm_size(node_comm, &node_size);
+    array<int, 3> lo = coords, hi = coords;
+    MPI_Allreduce(MPI_IN_PLACE, &lo[0], 3, MPI_INT, MPI_MIN, node_comm);
+    MPI_Allreduce(MPI_IN_PLACE, &hi[0], 3, MPI_INT, MPI_MAX, node_comm);
+    EXPECT_EQ((hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1), node_size);
+
+    MPI_3D_process_grid_t<3> grid({true, false, false}, comm);
+    EXPECT_EQ(grid.dimensions(), dims);
+    EXPECT_EQ(grid.coordinates(), coords);
+
+    MPI_Comm_free(&node_comm);
+    MPI_Comm_free(&comm);
+}
@@ -63,8 +63,46 @@ def test_cuda_sid():
         version=2)
     testee.check_cuda_sid(mock, 0xDEADBEAF, (4 * 5, 5, 1), (3, 4, 5))
 
+def test_3d_without_gil():
+    src = np.fromfunction(lambda i, j, k : i + j + k, (3, 4, 5), dtype=np.double)
+    dst = np.zeros_like(src)
+    testee.copy_from_3D_without_gil(src, dst)
+    assert np.all(dst == src)
+
+def test_3d_async():
+    srcs = [np.fromfunction(lambda i, j, k : i + j + k + n, (30, 40, 50), dtype=np.double) for n in range(4)]
+    dsts = [np.zeros_like(src) for src in srcs]
+    handles = [testee.copy_from_3D_async(src, dst) for src, dst in zip(srcs, dsts)]
+    # the sources are pinned by the running computations
+    del srcs
+    for handle in handles:
+        handle.wait()
+        assert handle.done()
+    for n, dst in enumerate(dsts):
+        assert np.all(dst == np.fromfunction(lambda i, j, k : i + j + k + n, (30, 40, 50), dtype=np.double))
+
+def test_dlpack_import():
+    src = np.fromfunction(lambda i, j, k : i + j + k, (3, 4, 5), dtype=np.double)
+    dst = np.zeros_like(src)
+    testee.copy_from_dlpack(src[:, ::-1, :], dst)
+    assert np.all(dst == src[:, ::-1, :])
+
+def test_dlpack_export():
+    field = testee.make_field(3, 4, 5)
+    arr = np.from_dlpack(field)
+    expected = np.fromfunction(lambda i, j, k : i + j + k, (3, 4, 5), dtype=np.double)
+    assert np.all(arr == expected)
+    # the memory is shared with the GridTools field, which is kept alive by the array
+    del field
+    assert np.all(arr == expected)
+
 test_3d()
 test_3d_with_unit_stride()
 test_1d()
 test_scalar()
 test_cuda_sid()
+test_3d_without_gil()
+test_3d_async()
+if hasattr(np, "from_dlpack"):
+    test_dlpack_import()
+    test_dlpack_export()
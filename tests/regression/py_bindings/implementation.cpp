@@ -10,6 +10,8 @@
 // Keep first to test for missing includes
 #include <gridtools/storage/adapter/python_sid_adapter.hpp>
 
+#include <gridtools/storage/adapter/python_async.hpp>
+
 #include <cassert>
 #include <cstdlib>
 #include <utility>
@@ -27,6 +29,8 @@
 #include <gridtools/stencil/cartesian.hpp>
 #include <gridtools/stencil/global_parameter.hpp>
 #include <gridtools/stencil/naive.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
 
 namespace py = pybind11;
 
@@ -86,6 +90,19 @@ void check_cuda_sid(T &&testee,
     check_hymap(sid::get_lower_bounds(testee), std::vector<size_t>(tuple_util::size<lower_bounds_t>()));
 }
 
+// A field owned by GridTools that is handed to Python via DLPack without a copy.
+struct field {
+    decltype(storage::builder<storage::cpu_kfirst>.type<double>().dimensions(0, 0, 0).build()) m_ds;
+};
+
+field make_field(int i, int j, int k) {
+    return {storage::builder<storage::cpu_kfirst>
+                .type<double>()
+                .dimensions(i, j, k)
+                .initializer([](int i, int j, int k) { return i + j + k; })
+                .build()};
+}
+
 // The module exports several instantiations of the generic `copy` to python.
 // The differences between exported functions are in the way how parameters model the SID concept.
 // Note that the generic algorithm stays the same.
@@ -115,4 +132,32 @@ PYBIND11_MODULE(py_implementation, m) {
             check_cuda_sid(as_cuda_sid<double const, 3>(testeee), ptr, strides, dims);
         },
         "Check CUDA Sid.");
+    m.def(
+        "copy_from_3D_without_gil",
+        [](py::buffer from, py::buffer to) {
+            call_without_gil([](auto &&from, auto &&to) { copy(from, to); },
+                as_sid<double const, 3>(from),
+                as_sid<double, 3>(to));
+        },
+        "Copy from one 3D buffer of doubles to another, the GIL is released during the copy.");
+    bind_async_handle(m);
+    m.def(
+        "copy_from_3D_async",
+        [](py::buffer from, py::buffer to) {
+            return async_call([](auto &&from, auto &&to) { copy(from, to); },
+                as_sid<double const, 3>(from),
+                as_sid<double, 3>(to));
+        },
+        "Start copying from one 3D buffer of doubles to another on a separate thread, returns a waitable handle.");
+    m.def(
+        "copy_from_dlpack",
+        [](py::object from, py::buffer to) { copy(as_dlpack_sid<double const, 3>(from), as_sid<double, 3>(to)); },
+        "Copy from a 3D DLPack tensor of doubles to a 3D buffer of doubles.");
+    py::class_<field>(m, "Field")
+        .def(
+            "__dlpack__",
+            [](field const &f, py::object /*stream*/) { return to_dlpack_capsule(f.m_ds); },
+            py::arg("stream") = py::none())
+        .def("__dlpack_device__", [](field const &f) { return dlpack_device(f.m_ds); });
+    m.def("make_field", &make_field, "Make a GridTools field initialized with i + j + k.");
 }
@@ -11,7 +11,9 @@
 #include <gtest/gtest.h>
 
 #include <cstdlib>
+#include <limits>
 
+#include <gridtools/common/omp.hpp>
 #include <gridtools/reduction.hpp>
 #include <gridtools/stencil/cartesian.hpp>
 
@@ -72,4 +74,56 @@ namespace {
         EXPECT_NEAR(comp(), TypeParam::d(0) * TypeParam::d(1) * TypeParam::d(2), default_precision<float_t>());
     }
 
+    struct copy_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    GT_REGRESSION_TEST(maximum, test_environment<>, reduction_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        auto out = reduction::make_reducible<reduction_backend_t, storage_traits_t>(
+            std::numeric_limits<float_t>::lowest(), TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto in = TypeParam::make_const_storage([](int i, int j, int k) { return float_t(i + j - k); });
+        run_single_stage(copy_functor(), stencil_backend_t(), TypeParam::make_grid(), out, in);
+        EXPECT_EQ(out.reduce(reduction::max()), TypeParam::d(0) + TypeParam::d(1) - 2);
+        TypeParam::benchmark("maximum", [&] { return out.reduce(reduction::max()); });
+    }
+
+#ifdef GT_REDUCTION_CPU
+    GT_REGRESSION_TEST(scalar_product_reproducible, test_environment<>, reduction_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        auto init = [](int, int, int) { return std::rand(); };
+        auto comp = [out = reduction::make_reducible<reduction::cpu_reproducible, storage_traits_t>(
+                         float_t(0), TypeParam::d(0), TypeParam::d(1), TypeParam::d(2)),
+                        grid = TypeParam::make_grid(),
+                        lhs = TypeParam::make_const_storage(init),
+                        rhs = TypeParam::make_const_storage(init)] {
+            run_single_stage(mul_functor(), stencil_backend_t(), grid, out, lhs, rhs);
+            return out.reduce(reduction::plus());
+        };
+        TypeParam::benchmark("scalar_product_reproducible", comp);
+    }
+
+    GT_REGRESSION_TEST(reproducible_summation, test_environment<>, reduction_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        auto out = reduction::make_reducible<reduction::cpu_reproducible, storage_traits_t>(
+            float_t(0), TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto init =
+            TypeParam::make_const_storage([](int i, int j, int k) { return float_t(1) / (1 + i + 3 * j + 7 * k); });
+        run_single_stage(mul_functor(), stencil_backend_t(), TypeParam::make_grid(), out, init, init);
+        int max_threads = omp_get_max_threads();
+        auto expected = out.reduce(reduction::plus());
+        for (int threads = 1; threads <= 2 * max_threads + 1; ++threads) {
+            omp_set_num_threads(threads);
+            EXPECT_EQ(out.reduce(reduction::plus()), expected);
+        }
+        omp_set_num_threads(max_threads);
+    }
+#endif
 } // namespace
@@ -8,6 +8,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <atomic>
+
 #include <gtest/gtest.h>
 
 #include <gridtools/boundaries/boundary.hpp>
@@ -889,3 +891,80 @@ TEST(boundaryconditions, basic) { EXPECT_EQ(basic(), true); }
 TEST(boundaryconditions, usingvalue2) { EXPECT_EQ(usingvalue_2(), true); }
 
 TEST(boundaryconditions, usingcopy3) { EXPECT_EQ(usingcopy_3(), true); }
+
+#ifndef GT_STORAGE_GPU
+TEST(boundaryconditions, fused_tasks) {
+    uint_t d1 = 6;
+    uint_t d2 = 5;
+    uint_t d3 = 7;
+
+    array<halo_descriptor, 3> halos;
+    halos[0] = halo_descriptor(2, 1, 2, d1 - 2, d1);
+    halos[1] = halo_descriptor(1, 1, 1, d2 - 2, d2);
+    halos[2] = halo_descriptor(0, 2, 0, d3 - 3, d3);
+
+    auto a = make_storage(d1, d2, d3, -1);
+    auto b = make_storage(d1, d2, d3, -1);
+    auto ref_a = make_storage(d1, d2, d3, -1);
+    auto ref_b = make_storage(d1, d2, d3, -1);
+
+    boundary_apply<bc_basic> basic_apply(halos);
+    boundary_apply<bc_two, minus_predicate> two_apply(halos);
+
+    // both boundary conditions in a single parallel region
+    apply_impl_::run(basic_apply.make_task(a->target_view()), two_apply.make_task(b->target_view()));
+
+    basic_apply.apply(ref_a->target_view());
+    two_apply.apply(ref_b->target_view());
+
+    auto av = a->const_host_view();
+    auto bv = b->const_host_view();
+    auto ref_av = ref_a->const_host_view();
+    auto ref_bv = ref_b->const_host_view();
+    for (uint_t i = 0; i < d1; ++i)
+        for (uint_t j = 0; j < d2; ++j)
+            for (uint_t k = 0; k < d3; ++k) {
+                bool halo = i < 2 || i > d1 - 2 || j < 1 || j > d2 - 2 || k > d3 - 3;
+                EXPECT_EQ(av(i, j, k), halo ? int_t(i + j + k) : -1) << i << " " << j << " " << k;
+                EXPECT_EQ(bv(i, j, k), ref_bv(i, j, k)) << i << " " << j << " " << k;
+                EXPECT_EQ(av(i, j, k), ref_av(i, j, k));
+            }
+}
+
+// fails if a direction is applied after a direction of higher index has started
+std::atomic<int> highest_direction;
+std::atomic<bool> out_of_order;
+
+struct bc_ordered {
+    static constexpr bool ordered_directions = true;
+
+    template <sign I, sign J, sign K, typename DataField0>
+    void operator()(direction<I, J, K>, DataField0 &data_field0, uint_t i, uint_t j, uint_t k) const {
+        constexpr int d = (I + 1) * 9 + (J + 1) * 3 + K + 1;
+        int highest = highest_direction.load();
+        while (highest < d && !highest_direction.compare_exchange_weak(highest, d))
+            ;
+        if (highest > d)
+            out_of_order = true;
+        data_field0(i, j, k) = d;
+    }
+};
+
+TEST(boundaryconditions, ordered_directions) {
+    uint_t d1 = 40;
+    uint_t d2 = 30;
+    uint_t d3 = 20;
+
+    array<halo_descriptor, 3> halos;
+    halos[0] = halo_descriptor(2, 2, 2, d1 - 3, d1);
+    halos[1] = halo_descriptor(2, 2, 2, d2 - 3, d2);
+    halos[2] = halo_descriptor(2, 2, 2, d3 - 3, d3);
+
+    auto a = make_storage(d1, d2, d3, -1);
+    highest_direction = 0;
+    out_of_order = false;
+    boundary_apply<bc_ordered>(halos).apply(a->target_view());
+    EXPECT_FALSE(out_of_order);
+    EXPECT_EQ(highest_direction, 26);
+}
+#endif
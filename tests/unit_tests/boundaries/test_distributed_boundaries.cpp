@@ -11,6 +11,11 @@
 #include <gridtools/boundaries/distributed_boundaries.hpp>
 
 #include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <mpi.h>
@@ -154,6 +159,18 @@ TEST_F(distributed_boundaries_test, boundary_only) {
     expect_d([&](int i, int j, int k) { return from_core(i, j) ? d_init(i, j, k) : triplet{}; });
 }
 
+TEST_F(distributed_boundaries_test, dependent_jobs) {
+    // the second job reads the halos written by the first one
+    testee.boundary_only(
+        bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a), bind_bc(copy_boundary(), b, _1).associate(a));
+    expect_a([&](int i, int j, int k) {
+        return from_core(i, j) ? a_init(i, j, k) : from_abroad(i, j) ? triplet{42, 42, 42} : triplet{};
+    });
+    expect_b([&](int i, int j, int k) {
+        return from_core(i, j) ? b_init(i, j, k) : from_abroad(i, j) ? triplet{42, 42, 42} : triplet{};
+    });
+}
+
 TEST_F(distributed_boundaries_test, exchange) {
     testee.exchange(
         bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a), bind_bc(copy_boundary(), b, _1).associate(c), d);
@@ -161,3 +178,158 @@ TEST_F(distributed_boundaries_test, exchange) {
     expect_b([&](int i, int j, int k) { return from_abroad(i, j) ? c_init(i, j, k) : b_init(i, j, k); });
     expect_d([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{} : d_init(i, j, k); });
 }
+
+TEST_F(distributed_boundaries_test, too_many_stores) {
+    EXPECT_THROW(testee.exchange(a, b, c, d), std::runtime_error);
+    EXPECT_THROW(testee.start_exchange(a, b, c, d), std::runtime_error);
+}
+
+TEST_F(distributed_boundaries_test, split_phase_exchange) {
+    testee.start_exchange(
+        bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a), bind_bc(copy_boundary(), b, _1).associate(c), d);
+    testee.wait(
+        bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a), bind_bc(copy_boundary(), b, _1).associate(c), d);
+    expect_a([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{42, 42, 42} : a_init(i, j, k); });
+    expect_b([&](int i, int j, int k) { return from_abroad(i, j) ? c_init(i, j, k) : b_init(i, j, k); });
+    expect_d([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{} : d_init(i, j, k); });
+}
+
+struct test_extent {
+    using iminus = std::integral_constant<int, -1>;
+    using iplus = std::integral_constant<int, 0>;
+    using jminus = std::integral_constant<int, -1>;
+    using jplus = std::integral_constant<int, 0>;
+    using kminus = std::integral_constant<int, 0>;
+    using kplus = std::integral_constant<int, 0>;
+};
+
+TEST_F(distributed_boundaries_test, exchange_and_compute) {
+    // counts how many times each point of the compute domain is computed, and whether it is after the exchange
+    int count[d1][d2][d3] = {};
+    bool done = false;
+    int num_interior = 0;
+    testee.exchange_and_compute(
+        test_extent(),
+        [&](array<halo_descriptor, 3> const &region) {
+            if (!done)
+                ++num_interior;
+            for (int i = region[0].begin(); i <= (int)region[0].end(); ++i)
+                for (int j = region[1].begin(); j <= (int)region[1].end(); ++j)
+                    for (int k = region[2].begin(); k <= (int)region[2].end(); ++k) {
+                        ++count[i][j][k];
+                        // the points which read the halos are computed after the exchange
+                        bool near_halo = i == halo_size || j == halo_size;
+                        EXPECT_EQ(near_halo, done);
+                        EXPECT_EQ(a->const_host_view()(i, j, k), a_init(i, j, k));
+                    }
+            done = done || num_interior == 1;
+        },
+        bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a),
+        d);
+    EXPECT_EQ(num_interior, 1);
+    for (int i = 0; i < d1; ++i)
+        for (int j = 0; j < d2; ++j)
+            for (int k = 0; k < d3; ++k)
+                EXPECT_EQ(count[i][j][k], from_core(i, j) ? 1 : 0) << i << ", " << j << ", " << k;
+    expect_a([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{42, 42, 42} : a_init(i, j, k); });
+    expect_d([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{} : d_init(i, j, k); });
+}
+
+struct symmetric_extent {
+    using iminus = std::integral_constant<int, -1>;
+    using iplus = std::integral_constant<int, 1>;
+    using jminus = std::integral_constant<int, -1>;
+    using jplus = std::integral_constant<int, 1>;
+    using kminus = std::integral_constant<int, 0>;
+    using kplus = std::integral_constant<int, 0>;
+};
+
+TEST_F(distributed_boundaries_test, exchange_and_compute_steps) {
+    std::vector<array<halo_descriptor, 3>> regions;
+    testee.exchange_and_compute_steps(
+        2,
+        symmetric_extent(),
+        [&](array<halo_descriptor, 3> const &region) { regions.push_back(region); },
+        bind_bc(value_boundary<triplet>(triplet{42, 42, 42}), a),
+        d);
+    ASSERT_EQ(regions.size(), 2);
+    // the first step computes redundantly one point deep into the halos shared with the neighbors
+    int minus[3] = {testee.proc_grid().proc(-1, 0, 0) != -1, testee.proc_grid().proc(0, -1, 0) != -1, 0};
+    int plus[3] = {testee.proc_grid().proc(1, 0, 0) != -1, testee.proc_grid().proc(0, 1, 0) != -1, 0};
+    for (int d = 0; d < 3; ++d) {
+        EXPECT_EQ(regions[0][d].begin(), halos[d].begin() - minus[d]);
+        EXPECT_EQ(regions[0][d].end(), halos[d].end() + plus[d]);
+        EXPECT_EQ(regions[1][d].begin(), halos[d].begin());
+        EXPECT_EQ(regions[1][d].end(), halos[d].end());
+    }
+    expect_a([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{42, 42, 42} : a_init(i, j, k); });
+    expect_d([&](int i, int j, int k) { return from_abroad(i, j) ? triplet{} : d_init(i, j, k); });
+}
+
+TEST_F(distributed_boundaries_test, deep_halos_too_narrow) {
+    // the step with 2 steps left computes 1 point into the halos of width 2 and reads 1 point further
+    EXPECT_NO_THROW(testee.deep_halo_region(symmetric_extent(), 2));
+    auto const &grid = testee.proc_grid();
+    if (grid.proc(1, 0, 0) != -1 || grid.proc(-1, 0, 0) != -1 || grid.proc(0, 1, 0) != -1 ||
+        grid.proc(0, -1, 0) != -1) {
+        EXPECT_THROW(testee.deep_halo_region(symmetric_extent(), 3), std::runtime_error);
+    } else {
+        EXPECT_NO_THROW(testee.deep_halo_region(symmetric_extent(), 3));
+    }
+}
+
+// the values of the series of the first output with the given name in the metrics
+std::vector<double> metrics_series(std::string const &metrics, std::string const &name) {
+    auto pos = metrics.find("\"name\" : \"" + name + "\"");
+    EXPECT_NE(pos, std::string::npos) << name;
+    pos = metrics.find('[', metrics.find("\"series\"", pos)) + 1;
+    std::istringstream series(metrics.substr(pos, metrics.find(']', pos) - pos));
+    std::vector<double> res;
+    double val;
+    char comma;
+    while (series >> val) {
+        res.push_back(val);
+        series >> comma;
+    }
+    return res;
+}
+
+TEST_F(distributed_boundaries_test, metrics) {
+    testee.exchange(a);
+    testee.reset_meters();
+    testee.exchange(a, b);
+    testee.start_exchange(a, b, d);
+    testee.wait(a, b, d);
+    auto metrics = testee.metrics_json();
+
+    EXPECT_EQ(metrics_series(metrics, "pack").size(), 2);
+    EXPECT_EQ(metrics_series(metrics, "wait").size(), 2);
+    // all the fields have the same halos
+    auto field_bytes = metrics_series(metrics, "field_bytes");
+    ASSERT_EQ(field_bytes.size(), 2);
+    EXPECT_EQ(field_bytes[0], field_bytes[1]);
+
+    auto const &grid = testee.proc_grid();
+    int neighbors = 0;
+    for (int k = -1; k <= 1; ++k)
+        for (int j = -1; j <= 1; ++j)
+            for (int i = -1; i <= 1; ++i)
+                neighbors += (i || j || k) && grid.proc(i, j, k) != -1;
+    size_t outputs = 0;
+    for (auto pos = metrics.find("\"name\" : \"neighbor_sent_bytes\""); pos != std::string::npos;
+         pos = metrics.find("\"name\" : \"neighbor_sent_bytes\"", pos + 1))
+        ++outputs;
+    EXPECT_EQ(outputs, neighbors);
+    if (neighbors) {
+        EXPECT_GT(field_bytes[0], 0);
+        // the sent bytes of the neighbors sum up to those of the 5 fields exchanged
+        double sent = 0;
+        for (auto pos = metrics.find("\"name\" : \"neighbor_sent_bytes\""); pos != std::string::npos;
+             pos = metrics.find("\"name\" : \"neighbor_sent_bytes\"", pos + 1))
+            sent += metrics_series(metrics.substr(pos), "neighbor_sent_bytes")[0];
+        EXPECT_EQ(sent, 5 * field_bytes[0]);
+    }
+
+    testee.reset_meters();
+    EXPECT_TRUE(metrics_series(testee.metrics_json(), "pack").empty());
+}
@@ -0,0 +1,121 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/boundaries/fused_boundaries.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/boundaries/copy.hpp>
+#include <gridtools/boundaries/value.hpp>
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/stencil/cpu_ifirst.hpp>
+#include <gridtools/stencil/cpu_kfirst.hpp>
+#include <gridtools/stencil/naive.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+#include <gridtools/storage/sid.hpp>
+
+namespace gridtools {
+    namespace boundaries {
+        namespace {
+            using namespace stencil;
+            using namespace cartesian;
+
+            struct copy_functor {
+                using in = in_accessor<0>;
+                using out = inout_accessor<1>;
+
+                using param_list = make_param_list<in, out>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(in());
+                }
+            };
+
+            constexpr int_t d1 = 37;
+            constexpr int_t d2 = 21;
+            constexpr int_t d3 = 9;
+            constexpr double halo_value = -1;
+
+            template <class Init>
+            auto make_storage(Init const &init) {
+                return storage::builder<storage::cpu_kfirst>.template type<double>().dimensions(d1, d2, d3).initializer(init)();
+            }
+
+            auto make_storage(double value) {
+                return storage::builder<storage::cpu_kfirst>.type<double>().dimensions(d1, d2, d3).value(value)();
+            }
+
+            using storage_t = decltype(make_storage(0.));
+
+            template <class Backend>
+            struct fused_boundaries : testing::Test {
+                array<halo_descriptor, 3> halos = {
+                    halo_descriptor(2, 3, 2, d1 - 4, d1), halo_descriptor(1, 2, 1, d2 - 3, d2), {0, 1, 0, d3 - 2, d3}};
+
+                storage_t in = make_storage([](int i, int j, int k) { return i + 100 * j + 10000 * k; });
+                storage_t out = make_storage(0.);
+                storage_t out2 = make_storage(0.);
+
+                auto make_grid() const { return stencil::make_grid(halos[0], halos[1], (int_t)halos[2].end() + 1); }
+
+                // the second job copies the halos the first job writes, so it checks that they run in order
+                auto backend() const {
+                    return with_boundaries(Backend(),
+                        halos,
+                        bind_bc(value_boundary<double>(halo_value), out),
+                        bind_bc(copy_boundary(), out2, out));
+                }
+
+                static bool is_halo(int_t x, halo_descriptor const &hd) {
+                    return x < (int_t)hd.begin() || x > (int_t)hd.end();
+                }
+
+                void verify() const {
+                    auto in_v = in->const_host_view();
+                    auto out_v = out->const_host_view();
+                    auto out2_v = out2->const_host_view();
+                    for (int_t i = 0; i < d1; ++i)
+                        for (int_t j = 0; j < d2; ++j)
+                            for (int_t k = 0; k < d3; ++k)
+                                if (is_halo(i, halos[0]) || is_halo(j, halos[1]) || is_halo(k, halos[2])) {
+                                    EXPECT_EQ(out_v(i, j, k), halo_value) << i << ", " << j << ", " << k;
+                                    EXPECT_EQ(out2_v(i, j, k), halo_value) << i << ", " << j << ", " << k;
+                                } else {
+                                    EXPECT_EQ(out_v(i, j, k), in_v(i, j, k)) << i << ", " << j << ", " << k;
+                                    EXPECT_EQ(out2_v(i, j, k), 0) << i << ", " << j << ", " << k;
+                                }
+                }
+            };
+
+            using backends_t = testing::Types<cpu_kfirst<>,
+                cpu_kfirst<integral_constant<int_t, 5>, integral_constant<int_t, 4>>,
+                cpu_ifirst<>,
+                naive>;
+
+            TYPED_TEST_SUITE(fused_boundaries, backends_t);
+
+            TYPED_TEST(fused_boundaries, parallel) {
+                run_single_stage(copy_functor(), this->backend(), this->make_grid(), this->in, this->out);
+                this->verify();
+            }
+
+            TYPED_TEST(fused_boundaries, forward) {
+                run([](auto in, auto out) { return execute_forward().stage(copy_functor(), in, out); },
+                    this->backend(),
+                    this->make_grid(),
+                    this->in,
+                    this->out);
+                this->verify();
+            }
+        } // namespace
+    }     // namespace boundaries
+} // namespace gridtools
@@ -0,0 +1,47 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/common/async_worker.hpp>
+
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace {
+        TEST(async_worker, runs_in_order_on_another_thread) {
+            async_worker testee;
+            std::vector<int> order;
+            std::promise<std::thread::id> id;
+            for (int i = 0; i != 10; ++i)
+                testee.submit([&order, i] { order.push_back(i); });
+            testee.submit([&id] { id.set_value(std::this_thread::get_id()); });
+            EXPECT_NE(id.get_future().get(), std::this_thread::get_id());
+            EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        }
+
+        TEST(async_worker, shutdown_runs_pending_tasks) {
+            async_worker testee;
+            std::promise<void> go;
+            auto started = go.get_future().share();
+            int done = 0;
+            testee.submit([started] { started.wait(); });
+            for (int i = 0; i != 3; ++i)
+                testee.submit([&done] { ++done; });
+            go.set_value();
+            testee.shutdown();
+            EXPECT_EQ(done, 3);
+            EXPECT_TRUE(testee.is_shut_down());
+            EXPECT_THROW(testee.submit([] {}), std::runtime_error);
+        }
+    } // namespace
+} // namespace gridtools
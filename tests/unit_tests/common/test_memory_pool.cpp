@@ -0,0 +1,144 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/common/memory_pool.hpp>
+
+#include <limits>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace {
+        struct alloc_f {
+            auto operator()(std::size_t size) const { return std::make_unique<char[]>(size); }
+        };
+
+        TEST(memory_pool, size_class) {
+            for (std::size_t i = 0; i <= 8; ++i)
+                EXPECT_EQ(memory_pool_impl_::size_class(i), i);
+            for (std::size_t i = 9; i < 100000; i += 7) {
+                auto c = memory_pool_impl_::size_class(i);
+                EXPECT_GE(c, i);
+                EXPECT_LE(c, i + i / 8);
+                EXPECT_EQ(memory_pool_impl_::size_class(c), c);
+            }
+        }
+
+        TEST(memory_pool, reuse) {
+            memory_pool_trim();
+            memory_pool_reset_statistics();
+            char *first;
+            {
+                auto ptr = memory_pool_allocate(alloc_f(), 1000);
+                first = ptr.get();
+            }
+            auto stats = memory_pool_statistics();
+            EXPECT_EQ(stats.misses, 1);
+            EXPECT_EQ(stats.cached_bytes, memory_pool_impl_::size_class(1000));
+
+            // a near-size request on another thread reuses the buffer
+            std::thread([&] {
+                auto ptr = memory_pool_allocate(alloc_f(), 999);
+                EXPECT_EQ(ptr.get(), first);
+            }).join();
+            stats = memory_pool_statistics();
+            EXPECT_EQ(stats.hits, 1);
+            EXPECT_DOUBLE_EQ(stats.hit_rate(), .5);
+            EXPECT_EQ(stats.peak_bytes, memory_pool_impl_::size_class(1000));
+
+            memory_pool_trim();
+            stats = memory_pool_statistics();
+            EXPECT_EQ(stats.cached_bytes, 0);
+            EXPECT_EQ(stats.current_bytes, 0);
+        }
+
+        std::unique_ptr<char[]> alloc_a(std::size_t size) { return std::make_unique<char[]>(size); }
+        std::unique_ptr<char[]> alloc_b(std::size_t size) { return std::make_unique<char[]>(size); }
+
+        TEST(memory_pool, function_pointers) {
+            memory_pool_trim();
+            char *first;
+            {
+                auto ptr = memory_pool_allocate(&alloc_a, 1000);
+                first = ptr.get();
+            }
+            // a function of the same type does not get the buffer of the other one
+            auto other = memory_pool_allocate(&alloc_b, 1000);
+            EXPECT_NE(other.get(), first);
+            auto same = memory_pool_allocate(&alloc_a, 1000);
+            EXPECT_EQ(same.get(), first);
+        }
+
+        struct stateful_alloc_f {
+            int device;
+            auto operator()(std::size_t size) const { return std::make_unique<char[]>(size); }
+        };
+
+        TEST(memory_pool, stateful_allocators_are_not_pooled) {
+            memory_pool_trim();
+            memory_pool_reset_statistics();
+            { memory_pool_allocate(stateful_alloc_f{0}, 1000); }
+            auto ptr = memory_pool_allocate(stateful_alloc_f{1}, 1000);
+            static_assert(std::is_same_v<decltype(ptr), std::unique_ptr<char[]>>);
+            auto stats = memory_pool_statistics();
+            EXPECT_EQ(stats.misses, 0);
+            EXPECT_EQ(stats.cached_bytes, 0);
+        }
+
+        TEST(memory_pool, cache_limit) {
+            memory_pool_trim();
+            memory_pool_set_cache_limit(1500);
+            {
+                auto a = memory_pool_allocate(alloc_f(), 1000);
+                auto b = memory_pool_allocate(alloc_f(), 1000);
+            }
+            auto stats = memory_pool_statistics();
+            EXPECT_EQ(stats.cached_bytes, memory_pool_impl_::size_class(1000));
+            EXPECT_EQ(stats.current_bytes, memory_pool_impl_::size_class(1000));
+            memory_pool_set_cache_limit(std::numeric_limits<std::size_t>::max());
+            memory_pool_trim();
+        }
+
+        // fails if more than 2000 bytes would be allocated at the same time
+        std::size_t limited_in_use = 0;
+
+        struct limited_alloc_f {
+            struct deleter {
+                std::size_t size;
+                void operator()(char *ptr) const {
+                    limited_in_use -= size;
+                    delete[] ptr;
+                }
+            };
+
+            std::unique_ptr<char[], deleter> operator()(std::size_t size) const {
+                if (limited_in_use + size > 2000)
+                    throw std::bad_alloc();
+                limited_in_use += size;
+                return {new char[size], {size}};
+            }
+        };
+
+        TEST(memory_pool, trim_on_failure) {
+            memory_pool_trim();
+            memory_pool_allocate(limited_alloc_f(), 1500);
+            EXPECT_EQ(limited_in_use, memory_pool_impl_::size_class(1500));
+
+            // the cached buffer is released to make room for the new one
+            auto ptr = memory_pool_allocate(limited_alloc_f(), 1800);
+            EXPECT_EQ(limited_in_use, memory_pool_impl_::size_class(1800));
+
+            // still failing after the trim
+            EXPECT_THROW(memory_pool_allocate(limited_alloc_f(), 1000), std::bad_alloc);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,102 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/gcl/high_level/compression.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace gridtools;
+using namespace gcl;
+
+namespace {
+    template <class T>
+    std::vector<T> smooth_values(std::size_t n) {
+        std::vector<T> res(n);
+        for (std::size_t i = 0; i != n; ++i)
+            res[i] = T(1000 + std::sin(i * 0.01) * 10);
+        return res;
+    }
+
+    template <class T>
+    std::vector<T> round_trip(halo_compression const &config, std::vector<T> const &values, std::size_t &size) {
+        std::vector<unsigned char> compressed(compressed_bound(values.size() * sizeof(T))), scratch;
+        size = compress(config, values.data(), values.size(), compressed.data(), scratch);
+        EXPECT_LE(size, compressed.size());
+        std::vector<T> res(values.size());
+        EXPECT_EQ(decompress(compressed.data(), res.data(), res.size(), scratch), size);
+        return res;
+    }
+
+    TEST(halo_compression, lossless) {
+        auto values = smooth_values<double>(10000);
+        std::size_t size;
+        EXPECT_EQ(round_trip(halo_compression::lossless(), values, size), values);
+        EXPECT_LT(size, values.size() * sizeof(double));
+    }
+
+    TEST(halo_compression, lossless_integers) {
+        std::vector<std::int64_t> values(5000);
+        for (std::size_t i = 0; i != values.size(); ++i)
+            values[i] = i / 7;
+        std::size_t size;
+        EXPECT_EQ(round_trip(halo_compression::lossless(), values, size), values);
+        EXPECT_LT(size, values.size() * sizeof(std::int64_t) / 4);
+    }
+
+    TEST(halo_compression, incompressible) {
+        std::mt19937 gen(0);
+        std::vector<std::uint32_t> values(3000);
+        for (auto &value : values)
+            value = gen();
+        std::size_t size;
+        EXPECT_EQ(round_trip(halo_compression::lossless(), values, size), values);
+        EXPECT_LE(size, compressed_bound(values.size() * sizeof(std::uint32_t)));
+    }
+
+    TEST(halo_compression, none) {
+        auto values = smooth_values<float>(100);
+        std::size_t size;
+        EXPECT_EQ(round_trip(halo_compression(), values, size), values);
+        EXPECT_EQ(size, compressed_bound(values.size() * sizeof(float)));
+    }
+
+    TEST(halo_compression, empty) {
+        std::vector<double> values;
+        std::size_t size;
+        EXPECT_EQ(round_trip(halo_compression::lossless(), values, size), values);
+    }
+
+    template <class T>
+    void check_lossy(double max_error) {
+        auto values = smooth_values<T>(10000);
+        values[3] = 0;
+        values[4] = -values[5];
+        values[6] = INFINITY;
+        std::size_t lossless_size, lossy_size;
+        round_trip(halo_compression::lossless(), values, lossless_size);
+        auto res = round_trip(halo_compression::lossy(max_error), values, lossy_size);
+        for (std::size_t i = 0; i != values.size(); ++i)
+            if (std::isfinite(values[i]))
+                EXPECT_LE(std::abs(res[i] - values[i]), max_error * std::abs(values[i])) << i;
+            else
+                EXPECT_EQ(res[i], values[i]) << i;
+        EXPECT_LT(lossy_size, lossless_size);
+    }
+
+    TEST(halo_compression, lossy) {
+        check_lossy<double>(1e-6);
+        check_lossy<double>(1e-3);
+        check_lossy<float>(1e-4);
+    }
+} // namespace
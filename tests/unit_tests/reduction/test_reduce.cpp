@@ -0,0 +1,87 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/reduction/reduce.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/tuple.hpp>
+#include <gridtools/reduction/functions.hpp>
+#include <gridtools/sid/simple_ptr_holder.hpp>
+#include <gridtools/sid/synthetic.hpp>
+#include <gridtools/sid/unknown_kind.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+#include <gridtools/storage/sid.hpp>
+
+namespace gridtools {
+    namespace {
+        template <class Traits>
+        class reduce_data_store : public testing::Test {};
+
+        using traits_t = testing::Types<storage::cpu_kfirst, storage::cpu_ifirst>;
+        TYPED_TEST_SUITE(reduce_data_store, traits_t);
+
+        TYPED_TEST(reduce_data_store, whole_field) {
+            auto ds = storage::builder<TypeParam>
+                          .template type<double>()
+                          .dimensions(9, 13, 7)
+                          .initializer([](int i, int j, int k) { return i + 10 * j + 100 * k; })
+                          .build();
+            auto lower = tuple(0, 0, 0);
+            auto upper = tuple(9, 13, 7);
+            EXPECT_EQ(reduction::reduce(ds, reduction::plus(), 0., lower, upper), 9 * 13 * 7 * (4 + 60 + 300));
+            EXPECT_EQ(reduction::reduce(ds, reduction::min(), 1e9, lower, upper), 0);
+            EXPECT_EQ(reduction::reduce(ds, reduction::max(), -1e9, lower, upper), 8 + 120 + 600);
+        }
+
+        TYPED_TEST(reduce_data_store, without_halos) {
+            auto ds = storage::builder<TypeParam>
+                          .template type<double>()
+                          .dimensions(9, 13, 7)
+                          .halos(2, 2, 0)
+                          .initializer([](int i, int j, int k) { return i + 10 * j + 100 * k; })
+                          .build();
+            auto res = reduction::reduce(ds, reduction::min(), 1e9, tuple(2, 2, 1), tuple(7, 11, 7));
+            EXPECT_EQ(res, 2 + 20 + 100);
+            res = reduction::reduce(ds, reduction::max(), -1e9, tuple(2, 2, 1), tuple(7, 11, 7));
+            EXPECT_EQ(res, 6 + 100 + 600);
+        }
+
+        TEST(reduce, masked_dimension) {
+            auto ds = storage::builder<storage::cpu_ifirst>
+                          .type<int>()
+                          .dimensions(5, 6, 7)
+                          .selector<1, 0, 1>()
+                          .initializer([](int i, int, int k) { return i * k; })
+                          .build();
+            // the masked dimension is visited once
+            EXPECT_EQ(reduction::reduce(ds, reduction::plus(), 0, tuple(0, 0, 0), tuple(5, 1, 7)), 10 * 21);
+        }
+
+        TEST(reduce, strided) {
+            // every other element of a large buffer, longer than a block
+            std::vector<long> data(20000);
+            for (size_t i = 0; i != data.size(); ++i)
+                data[i] = i % 2 ? -1000000 : long(i);
+            auto sid = sid::synthetic()
+                           .set<sid::property::origin>(sid::host_device::simple_ptr_holder<long *>{data.data()})
+                           .set<sid::property::strides>(tuple(2))
+                           .set<sid::property::strides_kind, sid::unknown_kind>();
+            EXPECT_EQ(reduction::reduce(sid, reduction::plus(), 0l, tuple(0), tuple(10000)), 9999l * 10000);
+        }
+
+        TEST(reduce, empty) {
+            auto ds = storage::builder<storage::cpu_kfirst>.type<int>().dimensions(3, 3, 3).value(1).build();
+            EXPECT_EQ(reduction::reduce(ds, reduction::plus(), 42, tuple(0, 1, 0), tuple(3, 1, 3)), 42);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,116 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/reduction.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <reduction_select.hpp>
+
+namespace gridtools {
+    namespace {
+        using testing::ElementsAre;
+
+        template <class Reducible, class F>
+        void fill(Reducible const &out, int ni, int nj, int nk, F f) {
+            auto ptr = sid::get_origin(out)();
+            auto &&strides = sid::get_strides(out);
+            for (int i = 0; i != ni; ++i)
+                for (int j = 0; j != nj; ++j)
+                    for (int k = 0; k != nk; ++k)
+                        ptr[i * tuple_util::get<0>(strides) + j * tuple_util::get<1>(strides) +
+                            k * tuple_util::get<2>(strides)] = f(i, j, k);
+        }
+
+        // the innermost dimension is padded to 64 bytes and 5 is not a multiple of 8, hence the buffer has holes
+        const int ni = 5, nj = 7, nk = 3;
+
+        auto make_field(double neutral) {
+            auto res = reduction::make_reducible<reduction_backend_t, storage::cpu_ifirst>(neutral, ni, nj, nk);
+            EXPECT_GT(res.m_size, size_t(ni * nj * nk));
+            fill(res, ni, nj, nk, [](int i, int j, int k) { return 1. + i - 2. * j + 3. * k; });
+            return res;
+        }
+
+        TEST(reducible, reduce_many) {
+            auto field = make_field(0);
+            auto res = field.reduce_many(reduction::min(),
+                reduction::max(),
+                reduction::plus(),
+                reduction::transformed(reduction::plus(), [](double x) { return x * x; }));
+            double sum = 0, sum_of_squares = 0;
+            for (int i = 0; i != ni; ++i)
+                for (int j = 0; j != nj; ++j)
+                    for (int k = 0; k != nk; ++k) {
+                        double x = 1. + i - 2. * j + 3. * k;
+                        sum += x;
+                        sum_of_squares += x * x;
+                    }
+            EXPECT_EQ(res[0], -11);
+            EXPECT_EQ(res[1], 11);
+            EXPECT_DOUBLE_EQ(res[2], sum);
+            EXPECT_DOUBLE_EQ(res[3], sum_of_squares);
+        }
+
+        TEST(reducible, minmax_ignores_padding) {
+            // the padding is filled with the neutral value, that is out of the range of the data here
+            auto field = make_field(100);
+            auto res = field.minmax();
+            EXPECT_EQ(res.first, -11);
+            EXPECT_EQ(res.second, 11);
+            // the padding is not visited by reduce either, the neutral value is the initial value
+            EXPECT_EQ(field.reduce(reduction::max()), 100);
+            EXPECT_EQ(field.reduce(reduction::min()), -11);
+            EXPECT_EQ(make_field(-100).reduce(reduction::max()), 11);
+        }
+
+        TEST(reducible, reduce_is_consistent_with_reduce_many) {
+            // with a value that is not neutral for the sum, the padding would change the result
+            auto field = make_field(1);
+            fill(field, ni, nj, nk, [](int, int, int) { return 1.; });
+            EXPECT_EQ(field.reduce_many(reduction::plus())[0], ni * nj * nk);
+            EXPECT_EQ(field.reduce(reduction::plus()), 1 + ni * nj * nk);
+        }
+
+        TEST(reducible, argmin_argmax) {
+            auto field = make_field(0);
+            auto min = field.argmin();
+            EXPECT_EQ(min.first, -11);
+            EXPECT_THAT(min.second, ElementsAre(0, 6, 0));
+            auto max = field.argmax();
+            EXPECT_EQ(max.first, 11);
+            EXPECT_THAT(max.second, ElementsAre(4, 0, 2));
+        }
+
+        TEST(reducible, argmin_first_occurrence) {
+            auto field = make_field(0);
+            fill(field, ni, nj, nk, [](int i, int j, int k) { return (i + j + k) % 4; });
+            auto min = field.argmin();
+            EXPECT_EQ(min.first, 0);
+            EXPECT_THAT(min.second, ElementsAre(0, 0, 0));
+            auto max = field.argmax();
+            EXPECT_EQ(max.first, 3);
+            // the smallest offset with the value 3 depends on the layout
+            auto &&strides = sid::get_strides(field);
+            auto offset = [&](auto const &idx) {
+                return idx[0] * tuple_util::get<0>(strides) + idx[1] * tuple_util::get<1>(strides) +
+                       idx[2] * tuple_util::get<2>(strides);
+            };
+            for (int i = 0; i != ni; ++i)
+                for (int j = 0; j != nj; ++j)
+                    for (int k = 0; k != nk; ++k)
+                        if ((i + j + k) % 4 == 3) {
+                            EXPECT_LE(offset(max.second), offset(array<int, 3>{i, j, k}));
+                        }
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/storage/adapter/dlpack.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+
+namespace gridtools {
+    namespace {
+        const auto builder = storage::builder<storage::cpu_kfirst>.type<double>().dimensions(3, 4, 5);
+
+        TEST(dlpack, export) {
+            auto ds = builder.initializer([](int i, int j, int k) { return i + 10 * j + 100 * k; }).build();
+            auto *tensor = dlpack::to_dlpack(ds);
+            EXPECT_EQ(ds.use_count(), 2);
+
+            auto &t = tensor->dl_tensor;
+            EXPECT_EQ(t.data, ds->get_target_ptr());
+            EXPECT_EQ(t.device.device_type, dlpack::kDLCPU);
+            EXPECT_EQ(t.ndim, 3);
+            EXPECT_EQ(t.dtype.code, dlpack::kDLFloat);
+            EXPECT_EQ(t.dtype.bits, 64);
+            EXPECT_EQ(t.dtype.lanes, 1);
+            for (int i = 0; i != 3; ++i) {
+                EXPECT_EQ(t.shape[i], ds->lengths()[i]);
+                EXPECT_EQ(t.strides[i], ds->strides()[i]);
+            }
+
+            tensor->deleter(tensor);
+            EXPECT_EQ(ds.use_count(), 1);
+        }
+
+        TEST(dlpack, round_trip) {
+            auto ds = builder.initializer([](int i, int j, int k) { return i + 10 * j + 100 * k; }).build();
+            auto view = ds->const_host_view();
+            {
+                auto testee = dlpack::as_sid<double, 3>(dlpack::to_dlpack(ds));
+                static_assert(is_sid<decltype(testee)>());
+                EXPECT_EQ(ds.use_count(), 2);
+
+                auto ptr = sid::get_origin(testee)();
+                auto strides = sid::get_strides(testee);
+                auto upper_bounds = sid::get_upper_bounds(testee);
+                EXPECT_EQ(tuple_util::get<0>(upper_bounds), 3);
+                EXPECT_EQ(tuple_util::get<1>(upper_bounds), 4);
+                EXPECT_EQ(tuple_util::get<2>(upper_bounds), 5);
+                for (int i = 0; i != 3; ++i)
+                    for (int j = 0; j != 4; ++j)
+                        for (int k = 0; k != 5; ++k)
+                            EXPECT_EQ(ptr[i * tuple_util::get<0>(strides) + j * tuple_util::get<1>(strides) +
+                                          k * tuple_util::get<2>(strides)],
+                                view(i, j, k));
+            }
+            EXPECT_EQ(ds.use_count(), 1);
+        }
+
+        TEST(dlpack, export_syncs_for_target_write) {
+            auto ds = builder.value(1).build();
+            auto *tensor = dlpack::to_dlpack(ds);
+            // the consumer writes to the exported memory, the next host view sees it
+            static_cast<double *>(tensor->dl_tensor.data)[0] = 42;
+            EXPECT_EQ(ds->const_host_view()(0, 0, 0), 42);
+            tensor->deleter(tensor);
+        }
+
+        TEST(dlpack, versioned_read_only) {
+            auto ds = storage::builder<storage::cpu_kfirst>.type<double const>().dimensions(3, 4, 5).value(7).build();
+            auto *tensor = dlpack::to_dlpack_versioned(ds);
+            EXPECT_EQ(tensor->version.major, 1);
+            EXPECT_EQ(tensor->flags, dlpack::DLPACK_FLAG_BITMASK_READ_ONLY);
+            EXPECT_EQ(tensor->dl_tensor.data, ds->get_const_target_ptr());
+            {
+                auto testee = dlpack::as_sid<double const, 3>(tensor);
+                EXPECT_EQ(*sid::get_origin(testee)(), 7);
+                EXPECT_EQ(ds.use_count(), 2);
+            }
+            EXPECT_EQ(ds.use_count(), 1);
+
+            // a read-only tensor is not imported as mutable
+            EXPECT_THROW((dlpack::as_sid<double, 3>(dlpack::to_dlpack_versioned(ds))), std::domain_error);
+            EXPECT_EQ(ds.use_count(), 1);
+
+            auto mutable_ds = builder.value(1).build();
+            auto *writable = dlpack::to_dlpack_versioned(mutable_ds);
+            EXPECT_EQ(writable->flags, 0);
+            dlpack::as_sid<double, 3>(writable);
+            EXPECT_EQ(mutable_ds.use_count(), 1);
+        }
+
+        TEST(dlpack, compact_strides) {
+            double data[2 * 3] = {};
+            std::int64_t shape[] = {2, 3};
+            dlpack::DLManagedTensor tensor = {{data, {dlpack::kDLCPU, 0}, 2, {dlpack::kDLFloat, 64, 1}, shape}};
+            auto testee = dlpack::as_sid<double, 2>(&tensor);
+            auto strides = sid::get_strides(testee);
+            EXPECT_EQ(tuple_util::get<0>(strides), 3);
+            EXPECT_EQ(tuple_util::get<1>(strides), 1);
+        }
+
+        TEST(dlpack, mismatch) {
+            double data[2 * 3] = {};
+            std::int64_t shape[] = {2, 3};
+            dlpack::DLManagedTensor tensor = {{data, {dlpack::kDLCPU, 0}, 2, {dlpack::kDLFloat, 64, 1}, shape}};
+            EXPECT_THROW((dlpack::as_sid<double, 3>(&tensor)), std::domain_error);
+            EXPECT_THROW((dlpack::as_sid<float, 2>(&tensor)), std::domain_error);
+            EXPECT_THROW((dlpack::as_sid<std::int64_t, 2>(&tensor)), std::domain_error);
+        }
+    } // namespace
+} // namespace gridtools
@@ -11,8 +11,11 @@
 #include <gtest/gtest.h>
 
 #include <cpp_bindgen/fortran_array_view.hpp>
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/sid/concept.hpp>
 #include <gridtools/storage/adapter/fortran_array_adapter.hpp>
 #include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
 #include <gridtools/storage/cpu_kfirst.hpp>
 
 const auto builder = gridtools::storage::builder<gridtools::storage::cpu_kfirst>.type<double>();
@@ -85,3 +88,97 @@ TEST(FortranArrayAdapter, TransformDataStoreIntoAdapter) {
             for (size_t x = 0; x < x_size; ++x, ++i)
                 EXPECT_EQ(fortran_array[z][y][x], i);
 }
+
+TEST(FortranArrayAdapter, ZeroCopySid) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    double fortran_array[z_size][y_size][x_size] = {};
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    // i-first layout matches the fortran layout
+    auto data_store = builder.layout<2, 1, 0>().dimensions(x_size, y_size, z_size)();
+    gridtools::fortran_array_adapter<decltype(data_store)> adapter{descriptor};
+
+    EXPECT_TRUE(adapter.is_layout_compatible(data_store));
+    auto sid = adapter.as_sid(data_store);
+    auto ptr = gridtools::sid::get_origin(sid)();
+    EXPECT_EQ(ptr, &fortran_array[0][0][0]);
+
+    auto strides = gridtools::sid::get_strides(sid);
+    ptr[gridtools::tuple_util::get<0>(strides) * 1 + gridtools::tuple_util::get<1>(strides) * 2 +
+        gridtools::tuple_util::get<2>(strides) * 3] = 42;
+    adapter.sync_from_sid(data_store);
+    EXPECT_EQ(fortran_array[3][2][1], 42);
+}
+
+TEST(FortranArrayAdapter, CopyingSid) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    double fortran_array[z_size][y_size][x_size] = {};
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+    fortran_array[3][2][1] = 1;
+
+    // k-first layout requires a copy
+    auto data_store = builder.dimensions(x_size, y_size, z_size)();
+    gridtools::fortran_array_adapter<decltype(data_store)> adapter{descriptor};
+
+    EXPECT_FALSE(adapter.is_layout_compatible(data_store));
+    auto sid = adapter.as_sid(data_store);
+    auto ptr = gridtools::sid::get_origin(sid)();
+    EXPECT_EQ(ptr, data_store->get_target_ptr());
+    EXPECT_EQ(data_store->const_host_view()(1, 2, 3), 1);
+
+    auto strides = gridtools::sid::get_strides(sid);
+    ptr[gridtools::tuple_util::get<0>(strides) * 1 + gridtools::tuple_util::get<1>(strides) * 2 +
+        gridtools::tuple_util::get<2>(strides) * 3] = 42;
+    EXPECT_EQ(fortran_array[3][2][1], 1);
+    adapter.sync_from_sid(data_store);
+    EXPECT_EQ(fortran_array[3][2][1], 42);
+}
+
+TEST(FortranArrayAdapter, AlignmentOfFirstInteriorElement) {
+    constexpr size_t x_size = 8;
+    constexpr size_t y_size = 3;
+    constexpr size_t z_size = 2;
+    alignas(64) double buffer[x_size * y_size * z_size + 8] = {};
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = bindgen_fk_Double;
+    descriptor.is_acc_present = false;
+
+    // the data store aligns the element (1, 0, 0) to 64 bytes
+    auto data_store = gridtools::storage::builder<gridtools::storage::cpu_ifirst>
+                          .type<double>()
+                          .layout<2, 1, 0>()
+                          .halos(1, 0, 0)
+                          .dimensions(x_size, y_size, z_size)();
+    using adapter_t = gridtools::fortran_array_adapter<decltype(data_store)>;
+
+    descriptor.data = buffer;
+    EXPECT_FALSE(adapter_t{descriptor}.is_layout_compatible(data_store));
+
+    descriptor.data = buffer + 7;
+    EXPECT_TRUE(adapter_t{descriptor}.is_layout_compatible(data_store));
+}
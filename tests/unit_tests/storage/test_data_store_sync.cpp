@@ -0,0 +1,139 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/layout_map.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/data_view.hpp>
+
+namespace gridtools {
+    namespace {
+        // the sizes of the copies between host and target, in elements
+        std::vector<size_t> to_target, to_host;
+
+        // host only mock of a storage with separate target memory and i-first layout
+        struct mock {
+            friend std::false_type storage_is_host_referenceable(mock) { return {}; }
+
+            friend layout_map<2, 1, 0> storage_layout(mock, std::integral_constant<size_t, 3>) { return {}; }
+
+            friend integral_constant<size_t, 1> storage_alignment(mock) { return {}; }
+
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(mock, LazyType, size_t size) {
+                return std::make_unique<T[]>(size);
+            }
+
+            template <class T>
+            friend void storage_update_target(mock, T *dst, T const *src, size_t size) {
+                std::copy_n(src, size, dst);
+                to_target.push_back(size);
+            }
+
+            template <class T>
+            friend void storage_update_host(mock, T *dst, T const *src, size_t size) {
+                std::copy_n(src, size, dst);
+                to_host.push_back(size);
+            }
+
+            template <class T, class Info>
+            friend auto storage_make_target_view(mock, T *ptr, Info const &info) {
+                return storage::make_host_view(ptr, info);
+            }
+        };
+
+        const auto builder = storage::builder<mock>.type<int>().dimensions(2, 3, 4);
+
+        class data_store_sync : public testing::Test {
+          protected:
+            void SetUp() override {
+                to_target.clear();
+                to_host.clear();
+            }
+        };
+
+        TEST_F(data_store_sync, whole_field) {
+            auto ds = builder.value(1).build();
+            ds->target_view();
+            EXPECT_EQ(to_target, std::vector<size_t>{24});
+            ds->host_view();
+            EXPECT_EQ(to_host, std::vector<size_t>{24});
+            ds->const_host_view();
+            ds->const_target_view();
+            EXPECT_EQ(to_target, (std::vector<size_t>{24, 24}));
+            EXPECT_EQ(to_host, std::vector<size_t>{24});
+        }
+
+        TEST_F(data_store_sync, target_address_does_not_sync) {
+            auto ds = builder.value(1).build();
+            void const *address = ds->target_address();
+            EXPECT_TRUE(to_target.empty());
+            EXPECT_EQ(address, ds->get_const_target_ptr());
+        }
+
+        TEST_F(data_store_sync, host_levels) {
+            auto ds = builder.value(1).build();
+            ds->target_view();
+            to_target.clear();
+
+            // only k = 1 and k = 2 are brought to the host and modified there
+            auto view = ds->host_view(1, 3);
+            EXPECT_EQ(to_host, std::vector<size_t>{12});
+            view(0, 0, 1) = 42;
+            view(1, 2, 2) = 43;
+
+            // only the modified levels are sent back
+            auto target = ds->const_target_view();
+            EXPECT_EQ(to_target, std::vector<size_t>{12});
+            EXPECT_EQ(target(0, 0, 1), 42);
+            EXPECT_EQ(target(1, 2, 2), 43);
+            EXPECT_EQ(target(0, 0, 0), 1);
+        }
+
+        TEST_F(data_store_sync, target_levels) {
+            auto ds = builder.value(1).build();
+            ds->const_target_view();
+            to_target.clear();
+
+            // the target modifies the levels k = 0 and k = 3
+            ds->target_view(0, 1)(1, 1, 0) = 5;
+            ds->target_view(3, 4)(1, 1, 3) = 6;
+            EXPECT_TRUE(to_target.empty());
+
+            // reading k = 1 does not require any copy
+            EXPECT_EQ(ds->const_host_view(1, 2)(1, 1, 1), 1);
+            EXPECT_TRUE(to_host.empty());
+
+            // the two modified levels are not contiguous
+            auto view = ds->const_host_view();
+            EXPECT_EQ(to_host, (std::vector<size_t>{6, 6}));
+            EXPECT_EQ(view(1, 1, 0), 5);
+            EXPECT_EQ(view(1, 1, 3), 6);
+        }
+
+        TEST_F(data_store_sync, adjacent_levels_are_merged) {
+            auto ds = builder.value(1).build();
+            ds->const_target_view();
+            to_target.clear();
+            ds->host_view(0, 1);
+            ds->host_view(1, 2);
+            ds->host_view(3, 4);
+            ds->target_view();
+            EXPECT_EQ(to_target, (std::vector<size_t>{12, 6}));
+        }
+    } // namespace
+} // namespace gridtools